@@ -0,0 +1,44 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdio.h>
+
+/*
+   Mode lot : beaucoup de petites chaînes (2 à 32 états) traitées ensemble.
+   Les chaînes sont regroupées par taille de noyau N (4, 8, 16 ou 32, états
+   manquants en bourrage) dans des tuiles de LOT_LARGEUR chaînes, rangées en
+   structure de tableaux : l'entrée (i, j) de toutes les chaînes d'une tuile
+   est contiguë, P[(i*N + j)*LOT_LARGEUR + c] pour la chaîne c. Les noyaux
+   (un par N, taille connue à la compilation) bouclent en dernier sur c et
+   se vectorisent à travers les chaînes.
+*/
+#define LOT_LARGEUR 64
+#define LOT_N_MAX   32
+#define LOT_ETAPES  256   // itérations avant de regrouper les chaînes lentes
+
+typedef struct {
+    int N;                      // taille de noyau (4, 8, 16 ou 32)
+    int nb;                     // chaînes présentes (<= LOT_LARGEUR)
+    int taille[LOT_LARGEUR];    // nombre d'états réels de chaque chaîne
+    int id[LOT_LARGEUR];        // identifiant libre (ex. : rang dans le fichier)
+    float *P;                   // N*N*LOT_LARGEUR
+} t_tuile;
+
+/* appelé par lireLot pour chaque chaîne (sommets 1-based) */
+typedef void (*t_rappel_chaine)(void *ctx, int n, int m, const int *depart,
+                                const int *arrivee, const float *proba);
+
+int tailleNoyau(int n);
+t_tuile *creerTuile(int N);
+void viderTuile(t_tuile *t);
+int ajouterChaineTuile(t_tuile *t, int n, int m, const int *depart, const int *arrivee,
+                       const float *proba, int id);
+void stationnaireTuile(t_tuile *t, float *pi, float epsilon, int max_iter, int *iterations);
+void puissanceTuile(t_tuile *t, int k, float *Pk);
+void periodeTuile(t_tuile *t, int *periodes);
+void libererTuile(t_tuile *t);
+
+int lireLot(const char *fichier, t_rappel_chaine rappel, void *ctx);
+int analyserLot(const char *fichier, FILE *out, float epsilon, int max_iter);
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "graph.h"
+
+/*
+   Cache persistant des résultats d'analyse, indexé par une empreinte
+   (hash FNV-1a 64 bits) de la liste d'arêtes normalisée.
+*/
+typedef struct {
+    unsigned long long complet;    // arêtes + probabilités
+    unsigned long long topologie;  // arêtes seulement
+} t_empreinte;
+
+/* niveaux de correspondance renvoyés par chargerCache */
+#define CACHE_ABSENT     0  // rien d'utilisable
+#define CACHE_TOPOLOGIE  1  // même structure : partition, Hasse et périodes réutilisables,
+                            // stationnaire utilisable comme point de départ
+#define CACHE_COMPLET    2  // même chaîne : tous les résultats sont réutilisables
+
+typedef struct {
+    int n;                  // nombre de sommets
+    t_partition partition;
+    t_link_array hasse;
+    int *periodes;          // periodes[i] = période de la classe i (0-based)
+    float *stationnaire;    // NULL si absent
+} t_resultat_cache;
+
+t_empreinte calculerEmpreinte(liste_adjacence la);
+int chargerCache(const char *dossier, t_empreinte e, int n, t_resultat_cache *r);
+int sauverCache(const char *dossier, t_empreinte e, t_resultat_cache *r);
+void libererResultatCache(t_resultat_cache *r);
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef CLASSES_H
+#define CLASSES_H
+
+#include "graph.h"
+#include "sparse.h"
+#include "spectral.h"
+#include "ordonnanceur.h"
+#include "precision.h"
+#include "reorder.h"
+
+/*
+   Analyse par classe en parallèle (sous-matrice, période, sommes de lignes,
+   limite p0 * S^k, persistance). Une tâche par classe, les plus grosses
+   soumises en premier ; une classe d'au moins CLASSE_SEUIL_PARALLELE arêtes,
+   ou dont le travail estimé (arêtes x itérations, cf. spectral.h) atteint
+   CLASSE_TRAVAIL_PARALLELE, découpe en plus chaque itération de sa limite en
+   sous-tâches (spmv.h).
+   Le texte de chaque classe est écrit dans son propre tampon et affiché
+   ensuite dans l'ordre des classes : la sortie ne dépend pas de l'ordonnancement.
+*/
+#ifndef CLASSE_SEUIL_PARALLELE
+#define CLASSE_SEUIL_PARALLELE (1L << 15)
+#endif
+#ifndef CLASSE_TRAVAIL_PARALLELE
+#define CLASSE_TRAVAIL_PARALLELE 1e9
+#endif
+
+typedef struct {
+    char *texte;
+    size_t len, cap;
+} t_sortie;
+
+typedef struct {
+    t_partition *partition;
+    t_link_array *hasse;
+    t_csr *sous_chaines;     // extraireSousChaines
+    int *periodes;
+    t_spectre *spectres;
+    float epsilon;
+    t_precision precision;   // limite des classes
+    t_permutation *permutation; // itérations sur le bloc renuméroté (NULL : ordre des membres)
+} t_contexte_classes;
+
+void estimerSpectres(t_ordonnanceur *o, liste_adjacence la, t_partition *p, int *vertex_to_class,
+                     float epsilon, t_spectre *spectres);
+t_sortie *analyserClasses(t_ordonnanceur *o, t_contexte_classes *ctx);
+void libererSorties(t_sortie *sorties, int nb);
+
+#endif
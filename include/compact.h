@@ -0,0 +1,46 @@
+#ifndef COMPACT_H
+#define COMPACT_H
+
+#include "sparse.h"
+#include <stdint.h>
+
+/*
+   Stockage compact du graphe (optionnel) pour les produits vecteur-matrice
+   limités par la bande passante mémoire :
+   - colonnes : par ligne, écarts entre colonnes successives (triées) codés
+     en varint (1 octet pour un écart < 128) ;
+   - probabilités : virgule fixe 16 bits (p = q / 65535, erreur < 1.6e-5 par
+     arête, somme de chaque ligne préservée au quantum près), ou dictionnaire de
+     valeurs distinctes indexé sur 16 bits (exact) quand il y en a <= 65536.
+   Environ 3 à 4 octets par arête, contre ~40 pour une cellule chaînée.
+*/
+/* compresserFichier : relectures du fichier au plus (une par tranche de lignes) ;
+   le tampon d'une tranche (8 octets par arête) reste de l'ordre du résultat */
+#define COMPACT_TRANCHES_MAX 4
+
+typedef enum {
+    COMPACT_FIXE16,
+    COMPACT_DICTIONNAIRE
+} t_mode_compact;
+
+typedef struct {
+    int n;
+    long nnz;
+    t_mode_compact mode;
+    uint64_t *debut_octets;  // n+1 : début de chaque ligne dans 'colonnes'
+    uint64_t *debut_aretes;  // n+1 : indice de la première arête de chaque ligne
+    uint8_t *colonnes;       // écarts varint
+    uint16_t *probas;        // nnz : valeur quantifiée ou index du dictionnaire
+    float *dictionnaire;     // mode dictionnaire uniquement
+    int taille_dictionnaire;
+    float erreur_max;        // plus grande erreur d'arrondi introduite
+} t_graphe_compact;
+
+t_graphe_compact compresserGraphe(t_csr *m, t_mode_compact mode);
+int compresserFichier(const char *chemin, t_mode_compact mode, long taille_bloc, t_graphe_compact *g);
+int stationnaireCompact(t_graphe_compact *g, float *pi, float epsilon, int max_iter);
+void multiplyVectorCompact(float *vec, t_graphe_compact *g, float *out);
+size_t tailleGrapheCompact(t_graphe_compact *g);
+void libererGrapheCompact(t_graphe_compact *g);
+
+#endif
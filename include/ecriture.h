@@ -0,0 +1,44 @@
+#ifndef ECRITURE_H
+#define ECRITURE_H
+
+#include "graph.h"
+#include "matrix.h"
+
+/*
+   Écriture tamponnée : le texte est formaté directement dans un grand tampon
+   (entiers et flottants à virgule fixe sans passer par printf) puis envoyé
+   par gros fwrite. Les erreurs d'écriture sont mémorisées et rendues par
+   fermerEcrivain, ce qui évite de tester chaque appel.
+*/
+#define ECRITURE_TAMPON (1 << 20)
+#define MATRICE_MAGIC 0x314D4B4DU   // "MKM1"
+#define VECTEUR_MAGIC 0x31564B4DU   // "MKV1"
+
+typedef struct {
+    FILE *f;
+    char *tampon;
+    size_t len;
+    int erreur;
+} t_ecrivain;
+
+void initEcrivain(t_ecrivain *e, FILE *f);
+void viderEcrivain(t_ecrivain *e);
+int fermerEcrivain(t_ecrivain *e);
+void ecrireOctets(t_ecrivain *e, const void *octets, size_t n);
+void ecrireTexte(t_ecrivain *e, const char *s);
+void ecrireCaractere(t_ecrivain *e, char c);
+void ecrireEntier(t_ecrivain *e, long long v);
+void ecrireFlottant(t_ecrivain *e, double v, int decimales);
+void ecrireIdSommet(t_ecrivain *e, int num);
+
+/* dumps de matrices et de vecteurs : CSV (8 décimales) ou
+   binaire (magic, dimensions, puis les flottants ligne par ligne) */
+int ecrireMatriceCSV(t_matrix m, const char *fichier);
+int ecrireMatriceBinaire(t_matrix m, const char *fichier);
+int ecrireGrapheCSV(liste_adjacence la, const char *fichier);
+int ecrireGrapheBinaire(liste_adjacence la, const char *fichier);
+int ecrireVecteurCSV(const float *v, int n, const char *fichier);
+int ecrireVecteurBinaire(const float *v, int n, const char *fichier);
+int ecrireGrapheTexte(liste_adjacence la, const char *fichier);
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef ESTIMATION_H
+#define ESTIMATION_H
+
+#include "graph.h"
+
+/*
+   Estimation de la matrice de transition à partir de séquences d'états
+   observées. Format du journal : une séquence par ligne, états numérotés à
+   partir de 1 séparés par des espaces, tabulations, virgules ou points-virgules ;
+   chaque couple d'états consécutifs d'une ligne est une transition observée.
+   Les lignes commençant par '#' sont ignorées ; une ligne contenant un autre
+   caractère est comptée invalide et n'apporte plus de transition après celui-ci.
+
+   Le fichier est lu en un seul passage, découpé en tranches de lignes lues en
+   parallèle (une table de hachage de comptages par thread), puis les tables
+   sont fusionnées, triées par (départ, arrivée) et normalisées par ligne
+   (maximum de vraisemblance : proba = compte / total sortant).
+*/
+typedef struct {
+    int depart;
+    int arrivee;
+    unsigned long long nb;
+} t_comptage;
+
+typedef struct {
+    int nb_etats;                    // plus grand état observé
+    long nb_comptages;               // transitions distinctes
+    t_comptage *comptages;           // triés par (départ, arrivée)
+    unsigned long long total;        // transitions observées
+    long long lignes_invalides;
+} t_estimation;
+
+int estimerTransitions(const char *fichier, int nb_threads, t_estimation *out);
+liste_adjacence grapheEstime(t_estimation *e);
+int ecrireGrapheEstime(t_estimation *e, const char *fichier);
+void libererEstimation(t_estimation *e);
+
+#endif
@@ -5,6 +5,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <setjmp.h>
+
+/* codes de retour de chargerGraphe */
+#define GRAPHE_OK            0
+#define GRAPHE_ERR_FICHIER (-1)  // fichier introuvable / illisible
+#define GRAPHE_ERR_FORMAT  (-2)  // nombre de sommets absent ou invalide
 
 /*
    Structures de la Partie 1
@@ -31,14 +37,44 @@ typedef struct {
 cellule* creerCellule(int arrivee, float proba);
 liste creerListe();
 void ajouterCellule(liste* l, int arrivee, float proba);
+cellule* trouverCellule(liste l, int arrivee);
+int supprimerCellule(liste* l, int arrivee);
 void afficherListe(liste l);
 liste_adjacence creerListeAdjacence(int taille);
 void afficherListeAdjacence(liste_adjacence la);
+int chargerGraphe(const char* filename, liste_adjacence* out, int* nb_ignorees);
 liste_adjacence readGraph(const char* filename);
-void verifierMarkov(liste_adjacence la);
+int verifierMarkov(liste_adjacence la);
 char* getId(int num);
+char* getIdR(int num, char *buf, size_t len);
+int ecrireMermaid(liste_adjacence la, const char* filename);
+int ecrireDot(liste_adjacence la, const char* filename);
 void exporterMermaid(liste_adjacence la, const char* filename);
 
+/* Erreurs fatales (allocation) : perror + exit, ou retour au point de reprise
+   installé par le thread courant (utilisé par la bibliothèque markov.h). */
+void erreurFatale(const char *msg);
+jmp_buf *definirPointReprise(jmp_buf *j);
+
+/* Ressources en cours de construction sous un point de reprise : erreurFatale
+   les libère (ordre inverse) avant le longjmp. Sans registre installé, suivre
+   et oublier ne font rien (comportement historique). */
+#define RESSOURCES_MAX 32
+typedef struct {
+    void *ptr[RESSOURCES_MAX];
+    void (*liberer[RESSOURCES_MAX])(void *);
+    int nb;
+} t_ressources;
+
+t_ressources *definirRessources(t_ressources *r);
+void suivreRessource(void *ptr, void (*liberer)(void *));
+void oublierRessource(void *ptr);
+void ressourceFichier(void *f);
+void ressourceListe(void *la);
+void ressourcePartition(void *p);
+void ressourceLiens(void *liens);
+void ressourcePile(void *s);
+
 /*
    Structures et fonctions Partie 2 (Tarjan / Hasse)
 */
@@ -96,8 +132,11 @@ t_link_array create_links_from_partition(liste_adjacence la, t_partition *p, int
 void init_link_array(t_link_array *la);
 void add_link_if_not_exists(t_link_array *la, int from, int to);
 int link_exists(t_link_array *la, int from, int to);
+int remove_link(t_link_array *la, int from, int to);
 void free_link_array(t_link_array *la);
 int* build_vertex_to_class_map(t_partition *p, int n);
+int ecrireMermaidHasse(t_partition *p, t_link_array *links, const char *filename);
+int ecrireDotHasse(t_partition *p, t_link_array *links, const char *filename);
 void exporterMermaidHasse(t_partition *p, t_link_array *links, const char *filename);
 int compute_caracteristics(t_partition *p, t_link_array *links, int class_number);
 void compute_and_print_characteristics(t_partition *p, t_link_array *links);
@@ -0,0 +1,50 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include "graph.h"
+
+/*
+   Ré-analyse incrémentale : on garde en mémoire le résultat d'une analyse
+   complète et on applique de petites modifications (deltas) sur les arêtes.
+*/
+typedef enum {
+    DELTA_AJOUT,        // ajoute l'arête depart -> arrivee
+    DELTA_SUPPRESSION,  // supprime l'arête depart -> arrivee
+    DELTA_POIDS         // modifie la probabilité de l'arête
+} t_delta_type;
+
+typedef struct {
+    t_delta_type type;
+    int depart;   // 1-based
+    int arrivee;  // 1-based
+    float proba;  // ignorée pour DELTA_SUPPRESSION
+} t_delta;
+
+/* valeurs de retour de appliquerDelta */
+#define DELTA_INVALIDE  (-1)  // sommet hors intervalle ou arête absente
+#define DELTA_LOCAL       0   // structure des classes inchangée (mise à jour locale)
+#define DELTA_RECALCUL    1   // les classes ont changé (Tarjan relancé)
+
+typedef struct {
+    liste_adjacence la;       // graphe courant (possédé par l'analyse)
+    t_partition partition;    // classes (Tarjan)
+    int *vertex_to_class;     // sommet -> classe (1-based)
+    t_link_array liens;       // liens bruts entre classes
+    t_link_array hasse;       // liens sans les arcs transitifs
+    float *stationnaire;      // distribution stationnaire courante
+    float epsilon;
+    int max_iter;
+    int iterations;           // itérations du dernier calcul stationnaire
+} t_analyse;
+
+t_analyse creerAnalyse(liste_adjacence la, float epsilon, int max_iter);
+int appliquerDelta(t_analyse *a, t_delta d);
+int appliquerDeltas(t_analyse *a, const t_delta *deltas, int nb);
+void libererAnalyse(t_analyse *a);
+
+/* fichier de deltas : une modification par ligne, "+ u v p" (ajout ou nouvelle
+   probabilité), "= u v p" (poids d'une arête existante), "- u v" (suppression) ;
+   lignes vides et commençant par '#' ignorées */
+int lireDeltas(const char *fichier, t_delta **deltas, int *nb, int *invalides);
+
+#endif
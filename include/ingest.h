@@ -0,0 +1,48 @@
+#ifndef INGEST_H
+#define INGEST_H
+
+#include "graph.h"
+
+/*
+   Chargement validé d'un graphe au format habituel. Le fichier est lu une
+   seule fois par gros blocs ; les arêtes sont rangées par ligne (tri par
+   comptage), puis un unique passage par ligne fusionne les doublons
+   (probabilités additionnées, repérés par marquage des arrivées), contrôle la
+   somme, renormalise si demandé et construit la liste d'adjacence : arêtes
+   par arrivée croissante, ou dans l'ordre de l'ancien readGraph (inverse du
+   fichier) si 'trier' vaut 0.
+   Rien n'est affiché : tout est rendu dans un t_rapport_ingest
+   (afficherRapportIngest l'imprime). chargerGraphe et readGraph passent
+   par ici, sans renormalisation ni tri.
+*/
+typedef struct {
+    int renormaliser;     // divise chaque ligne de somme non nulle par sa somme
+    float tolerance;      // somme acceptée dans [1 - tolerance, 1 + tolerance]
+    int trier;            // 1 : arêtes par arrivée croissante ; 0 : ordre inverse du fichier
+} t_options_ingest;
+
+typedef struct {
+    int statut;                   // GRAPHE_OK, GRAPHE_ERR_FICHIER ou GRAPHE_ERR_FORMAT
+    int n;
+    long long lignes;             // lignes d'arêtes lues
+    long long lignes_invalides;   // lignes qui ne sont pas "depart arrivee proba"
+    long long hors_intervalle;    // sommet hors de 1..n
+    long long probas_invalides;   // proba négative, > 1 ou nan
+    long long probas_nulles;      // arêtes de proba 0 (retirées)
+    long long doublons;           // lignes fusionnées dans une arête existante
+    long long aretes;             // arêtes du graphe produit
+    int lignes_vides;             // sommets sans arête sortante
+    int lignes_hors_somme;        // sommets dont la somme sort de la tolérance (avant renormalisation)
+    int premier_hors_somme;       // premier de ces sommets (0 si aucun)
+    int pire_sommet;              // sommet dont la somme est la plus éloignée de 1
+    float pire_somme;
+    int renormalisees;            // lignes modifiées par la renormalisation
+} t_rapport_ingest;
+
+void optionsIngestParDefaut(t_options_ingest *opt);
+int ingererGraphe(const char *fichier, const t_options_ingest *opt, liste_adjacence *out,
+                  t_rapport_ingest *rapport);
+int rapportValide(const t_rapport_ingest *rapport);
+void afficherRapportIngest(const t_rapport_ingest *rapport);
+
+#endif
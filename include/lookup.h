@@ -0,0 +1,43 @@
+#ifndef LOOKUP_H
+#define LOOKUP_H
+
+#include <stdint.h>
+#include "graph.h"
+#include "ordonnanceur.h"
+
+/*
+   Index des arêtes pour lire P(i -> j) en temps constant : table de hachage
+   à adressage ouvert sur la clé (i << 32) | j, remplie au quart au plus, dont
+   chaque case porte la probabilité et son logarithme précalculé. Une
+   recherche coûte en général une seule case (un seul accès mémoire).
+   Lecture seule après construction : utilisable par plusieurs threads.
+*/
+typedef struct {
+    uint64_t cle;      // 0 = case vide (les sommets sont 1-based)
+    float proba;
+    float log_proba;   // -INFINITY si proba <= 0
+} t_case_arete;
+
+typedef struct {
+    int n;
+    long nb_aretes;
+    size_t cap;        // puissance de 2
+    t_case_arete *cases;
+} t_index_aretes;
+
+/* score d'une trajectoire : les transitions absentes du graphe (ou de
+   probabilité nulle) sont comptées à part et exclues de la log-vraisemblance */
+typedef struct {
+    double log_vraisemblance;
+    long inconnues;
+    long premiere_inconnue;   // indice de l'état de départ de la 1re transition inconnue, -1 si aucune
+} t_score;
+
+t_index_aretes construireIndexAretes(liste_adjacence la);
+float probaArete(const t_index_aretes *idx, int depart, int arrivee);
+void scorerTrajectoires(const t_index_aretes *idx, const int *etats, const long *debut, int nb,
+                        t_score *scores, t_ordonnanceur *o);
+int lireTrajectoires(const char *fichier, int **etats, long **debut, int *nb);
+void libererIndexAretes(t_index_aretes *idx);
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef LUMP_H
+#define LUMP_H
+
+#include "graph.h"
+#include "precision.h"
+
+/*
+   Agrégation exacte (lumpabilité ordinaire) : plus grossière partition des
+   états telle que, pour tout couple de blocs (B, C), tous les états de B
+   ont la même probabilité totale d'aller dans C. La chaîne quotient est
+   alors une chaîne de Markov sur les blocs, souvent beaucoup plus petite
+   pour les modèles symétriques.
+
+   Calcul par raffinement de partition (style Paige-Tarjan / Valmari) : un
+   bloc "séparateur" découpe les blocs de ses prédécesseurs selon le poids
+   qu'ils envoient vers lui ; seuls les morceaux autres que le plus grand
+   sont remis en file, d'où O(m log n) séparations. Sans étiquettes, la
+   lumpabilité ordinaire seule est triviale (un bloc) : le mode strict sépare
+   aussi selon les poids entrants.
+*/
+#define LUMP_ORDINAIRE 0
+#define LUMP_STRICT    1
+
+typedef struct {
+    int n;
+    int nb_blocs;
+    int *bloc_de;   // bloc_de[v] pour v = 1..n, blocs numérotés 1..nb_blocs
+    int *taille;    // taille[b] pour b = 1..nb_blocs
+    int exacte;     // 1 si la partition est aussi exactement lumpable
+                    // (relèvement uniforme dans chaque bloc exact)
+} t_agregation;
+
+t_agregation calculerAgregation(liste_adjacence la, const int *etiquettes, int mode, float tolerance);
+liste_adjacence grapheQuotient(liste_adjacence la, t_agregation *ag);
+void agregerDistribution(t_agregation *ag, const float *p_etats, float *p_blocs);
+void releverDistribution(t_agregation *ag, const float *p_blocs, float *p_etats);
+int stationnaireParAgregation(liste_adjacence la, t_agregation *ag, float *pi, float epsilon, int max_iter,
+                              t_precision prec);
+void libererAgregation(t_agregation *ag);
+
+#endif
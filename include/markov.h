@@ -0,0 +1,54 @@
+#ifndef MARKOV_H
+#define MARKOV_H
+
+/*
+   libmarkov : interface de bibliothèque réentrante.
+   Toutes les données d'une chaîne vivent dans un contexte opaque ; aucune
+   fonction ne quitte le programme, les erreurs sont renvoyées sous forme de
+   code. Plusieurs contextes peuvent être utilisés en parallèle, et une fois
+   markov_analyser terminé les fonctions de requête d'un même contexte
+   peuvent être appelées depuis plusieurs threads.
+   Au chargement d'une grosse chaîne (spmv.h), le contexte crée ses propres
+   workers : la distribution stationnaire et markov_distribution_k répartissent
+   alors chaque produit vecteur-matrice entre eux.
+*/
+typedef struct markov_ctx markov_ctx;
+
+typedef enum {
+    MARKOV_OK = 0,
+    MARKOV_ERR_ARGUMENT,  // paramètre invalide (pointeur NULL, état ou classe hors intervalle)
+    MARKOV_ERR_FICHIER,   // fichier introuvable ou impossible à écrire
+    MARKOV_ERR_FORMAT,    // contenu du fichier invalide
+    MARKOV_ERR_MEMOIRE,   // allocation impossible
+    MARKOV_ERR_ETAT       // appel dans le mauvais ordre (ex : requête avant markov_analyser)
+} markov_statut;
+
+/* cycle de vie */
+markov_statut markov_creer(markov_ctx **ctx);
+void markov_detruire(markov_ctx *ctx);
+const char *markov_message(markov_statut s);
+
+/* chargement (remplace la chaîne précédente du contexte) ; états numérotés 1..n */
+markov_statut markov_charger_fichier(markov_ctx *ctx, const char *chemin);
+markov_statut markov_charger_aretes(markov_ctx *ctx, int n, const int *depart, const int *arrivee,
+                                    const float *proba, int nb_aretes);
+
+/* analyse complète : classes, Hasse, périodes, distribution stationnaire, index d'accessibilité */
+markov_statut markov_analyser(markov_ctx *ctx, float epsilon, int max_iter);
+
+/* requêtes (après markov_analyser) ; classes numérotées 1..nb_classes */
+int markov_nb_etats(const markov_ctx *ctx);
+int markov_nb_classes(const markov_ctx *ctx);
+markov_statut markov_classe_de(const markov_ctx *ctx, int etat, int *classe);
+markov_statut markov_membres_classe(const markov_ctx *ctx, int classe, const int **membres, int *taille);
+markov_statut markov_classe_persistante(const markov_ctx *ctx, int classe, int *persistante);
+markov_statut markov_periode(const markov_ctx *ctx, int classe, int *periode);
+markov_statut markov_stationnaire(const markov_ctx *ctx, int etat, float *proba);
+markov_statut markov_distribution_k(const markov_ctx *ctx, const float *p0, int k, float *out);
+markov_statut markov_atteignable(const markov_ctx *ctx, int i, int j, int *resultat);
+
+/* exports Mermaid et Graphviz DOT (chemins NULL ignorés) */
+markov_statut markov_exporter_mermaid(const markov_ctx *ctx, const char *graphe, const char *hasse);
+markov_statut markov_exporter_dot(const markov_ctx *ctx, const char *graphe, const char *hasse);
+
+#endif
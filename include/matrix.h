@@ -21,6 +21,8 @@ t_matrix multiplyMatrices(t_matrix m1, t_matrix m2, t_matrix result);
 float diffMatrices(t_matrix m1, t_matrix m2);
 t_matrix subMatrix(t_matrix matrix, t_partition part, int compo_index);
 int getPeriod(t_matrix sub_matrix);
+int gcd(int *vals, int nbvals);
+int getPeriodAdjacency(liste_adjacence la, t_partition *part, int *vertex_to_class, int compo_index);
 
 /* Distribution / vecteurs */
 float *createZeroVector(int n);
@@ -30,4 +32,8 @@ void multiplyVectorMatrix(float *vec, t_matrix mat, float *out);
 float diffVectors(float *v1, float *v2, int n);
 float *computeStationaryDistribution(t_matrix mat, float epsilon, int max_iter);
 
+/* Versions creuses (directement sur la liste d'adjacence) */
+void multiplyVectorAdjacency(float *vec, liste_adjacence la, float *out);
+int computeStationaryDistributionFrom(liste_adjacence la, float *p, float epsilon, int max_iter);
+
 #endif
@@ -0,0 +1,32 @@
+#ifndef ORDONNANCEUR_H
+#define ORDONNANCEUR_H
+
+#include <stdatomic.h>
+
+/*
+   Ordonnanceur de tâches à vol de travail (work stealing).
+   Chaque worker a sa propre file double : il dépile ses tâches par la fin
+   (les plus récentes, encore chaudes en cache) et, quand elle est vide, vole
+   par le début la file d'un autre worker. Une tâche peut soumettre des
+   sous-tâches puis attendre leur groupe : pendant l'attente, le thread
+   exécute lui-même les tâches disponibles, puis dort (variable de
+   condition) jusqu'à une nouvelle tâche ou la fin d'un groupe.
+   Le thread qui crée l'ordonnanceur soumet dans une file supplémentaire.
+*/
+typedef void (*t_fonction_tache)(void *arg);
+
+typedef struct {
+    atomic_int restantes;   // tâches soumises au groupe et pas encore terminées
+} t_groupe;
+
+typedef struct t_ordonnanceur t_ordonnanceur;
+
+t_ordonnanceur *creerOrdonnanceur(int nb_workers);
+void initGroupe(t_groupe *g);
+void soumettreTache(t_ordonnanceur *o, t_groupe *g, t_fonction_tache fn, void *arg);
+void attendreGroupe(t_ordonnanceur *o, t_groupe *g);
+int nombreWorkers(t_ordonnanceur *o);
+void detruireOrdonnanceur(t_ordonnanceur *o);
+int nombreCoeurs(void);
+
+#endif
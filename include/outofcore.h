@@ -0,0 +1,48 @@
+#ifndef OUTOFCORE_H
+#define OUTOFCORE_H
+
+#include <stdio.h>
+
+/*
+   Résolution hors mémoire : les transitions restent sur disque et sont
+   relues séquentiellement par gros blocs à chaque itération de puissance ;
+   seuls les vecteurs de taille n restent en mémoire. Un thread lecteur
+   remplit un bloc pendant que le calcul consomme l'autre (double tampon).
+
+   Formats acceptés :
+   - texte habituel (première ligne n, puis "depart arrivee proba") ;
+   - binaire : en-tête t_entete_binaire puis enregistrements t_arete_binaire.
+*/
+#define BINAIRE_MAGIC 0x31424B4DU  // "MKB1"
+#define BLOC_DEFAUT (1 << 20)      // arêtes par bloc (12 Mo)
+
+typedef struct {
+    unsigned int magic;
+    int n;
+    long long nnz;
+} t_entete_binaire;
+
+typedef struct {
+    int depart;   // 1-based
+    int arrivee;  // 1-based
+    float proba;
+} t_arete_binaire;
+
+/* lecture séquentielle des arêtes d'un fichier texte ou binaire (partagée avec compact.h) */
+typedef struct {
+    FILE *f;
+    int binaire;
+    int n;
+    int erreur;
+} t_fichier_aretes;
+
+int ouvrirFichierAretes(t_fichier_aretes *fa, const char *chemin);
+void rembobinerFichierAretes(t_fichier_aretes *fa);
+long lireAretes(t_fichier_aretes *fa, t_arete_binaire *dst, long max);
+void fermerFichierAretes(t_fichier_aretes *fa);
+
+long long convertirTexteEnBinaire(const char *texte, const char *binaire);
+int nombreSommetsFichier(const char *chemin);
+int stationnaireHorsMemoire(const char *chemin, float *pi, float epsilon, int max_iter, long taille_bloc);
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef PRECISION_H
+#define PRECISION_H
+
+#include "graph.h"
+#include "sparse.h"
+#include "spmv.h"
+
+/*
+   Noyaux vecteur-matrice génériques en précision : une seule source (macro
+   DEFINIR_NOYAUX dans precision.c) instanciée en float (suffixe _f) et en
+   double (suffixe _d).
+
+   Les itérations de puissance choisissent la précision à l'exécution :
+   - PRECISION_SIMPLE : tout en float, comme la boucle d'origine (le défaut
+     est désormais le mode mixte) ;
+   - PRECISION_DOUBLE : tout en double ;
+   - PRECISION_MIXTE  : itérations en float tant qu'elles progressent, puis
+     raffinement en double dès que l'écart entre deux itérés atteint le bruit
+     d'arrondi du float (sinon un epsilon de 1e-6 n'est jamais atteint et la
+     boucle tourne jusqu'à max_iter).
+   Les vecteurs d'entrée/sortie restent en float pour les appelants. Le
+   nombre d'itérations renvoyé suit la convention d'origine : le produit qui
+   passe sous epsilon n'est pas compté.
+   puissanceSpmv itère avec le produit tiré parallèle de spmv.h (mêmes
+   règles d'arrêt et de précision). precisionPourSpectre passe le mode mixte
+   en double d'emblée quand l'estimation spectrale annonce que le float ne
+   peut pas atteindre epsilon.
+*/
+typedef enum {
+    PRECISION_SIMPLE,
+    PRECISION_DOUBLE,
+    PRECISION_MIXTE
+} t_precision;
+
+#define PRECISION_DEFAUT PRECISION_MIXTE
+
+int precisionDepuisNom(const char *nom, t_precision *prec);
+const char *nomPrecision(t_precision prec);
+t_precision precisionPourSpectre(t_precision prec, float temps_melange, int n, float epsilon);
+
+void multiplyVectorAdjacency_f(const float *vec, liste_adjacence la, float *out);
+void multiplyVectorAdjacency_d(const double *vec, liste_adjacence la, double *out);
+void multiplyVectorCSR_f(const float *vec, t_csr *m, float *out);
+void multiplyVectorCSR_d(const double *vec, t_csr *m, double *out);
+float diffVectors_f(const float *v1, const float *v2, int n);
+double diffVectors_d(const double *v1, const double *v2, int n);
+
+int puissanceAdjacence(liste_adjacence la, float *p, float epsilon, int max_iter, t_precision prec);
+int puissanceCSR(t_csr *m, float *p, float epsilon, int max_iter, t_precision prec);
+int puissanceSpmv(const t_spmv *s, float *p, float epsilon, int max_iter, t_precision prec);
+
+#endif
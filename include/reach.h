@@ -0,0 +1,42 @@
+#ifndef REACH_H
+#define REACH_H
+
+#include "graph.h"
+#include <stdint.h>
+
+/*
+   Index d'accessibilité "i peut-il atteindre j ?" construit sur le graphe
+   des classes (DAG). Deux représentations :
+   - fermeture transitive en bitset (réponse O(1)) tant que le nombre de
+     classes reste modéré ;
+   - au-delà, étiquetage par intervalles (arbre couvrant + intervalles de
+     type GRAIL) qui répond en O(1) dans la plupart des cas et ne parcourt
+     le DAG (avec élagage) qu'en dernier recours. Mémoire O(n + classes).
+   Une fois construit, l'index n'est plus modifié : les requêtes peuvent être
+   faites depuis plusieurs threads.
+*/
+#ifndef REACH_BITSET_MAX_CLASSES
+#define REACH_BITSET_MAX_CLASSES 16384  // 16384^2 bits = 32 Mo
+#endif
+
+typedef struct {
+    int n;                  // nombre de sommets
+    int nb;                 // nombre de classes
+    int *vertex_to_class;   // copie de la table sommet -> classe (1-based)
+    /* mode bitset */
+    uint64_t *bits;         // nb lignes de 'words' mots, NULL si mode intervalles
+    int words;
+    /* mode intervalles */
+    int *succ_start;        // CSR du DAG des classes, succ_start[c]..succ_start[c+1]-1
+    int *succ;
+    int *pre, *post;        // intervalle de l'arbre couvrant (test positif)
+    int *low;               // min des post des descendants (test négatif)
+} t_reachability;
+
+t_reachability build_reachability_index(t_partition *p, t_link_array *links, int *vertex_to_class, int n);
+int class_can_reach(t_reachability *r, int from, int to);
+int can_reach(t_reachability *r, int i, int j);
+void free_reachability_index(t_reachability *r);
+void ressourceReach(void *r);
+
+#endif
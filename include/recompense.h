@@ -0,0 +1,44 @@
+#ifndef RECOMPENSE_H
+#define RECOMPENSE_H
+
+#include "graph.h"
+
+/*
+   Chaînes de Markov à récompenses.
+   - Valeur actualisée : V = r + gamma * P * V (0 <= gamma < 1), calculée pour
+     plusieurs vecteurs de récompenses et plusieurs facteurs à la fois : les
+     systèmes sont entrelacés (V[i * nb_systemes + s]) pour qu'une seule
+     lecture de chaque arête serve à tous.
+   - Récompense moyenne à long terme (gain) : pour une classe persistante,
+     somme de pi * r sur la classe ; pour un état transitoire, moyenne des
+     gains des classes persistantes pondérée par les probabilités d'absorption.
+   Les classes de Tarjan sont résolues en ordre topologique inverse (une
+   classe après toutes celles qu'elle atteint) : les valeurs en aval sont
+   alors connues et n'interviennent que par un terme constant, et chaque
+   classe est résolue seule sur sa sous-chaîne (itération de valeur ou
+   Gauss-Seidel, arrêt sur le résidu en norme infinie).
+*/
+typedef enum {
+    VALEUR_ITERATION,      // Jacobi : V <- r + gamma * P * V_precedent
+    VALEUR_GAUSS_SEIDEL    // mise à jour sur place, état par état
+} t_methode_valeur;
+
+typedef struct {
+    int n;
+    int nb_recompenses, nb_facteurs;
+    int nb_systemes;         // nb_recompenses * nb_facteurs ; s = k * nb_facteurs + f
+    double *valeurs;         // [i * nb_systemes + s], i = 0..n-1
+    double *gain;            // [i * nb_recompenses + k]
+    int *persistante;        // [c] pour c = 0..nb_classes-1
+    int iterations;          // plus grand nombre de balayages sur une classe
+    double residu;           // plus grand résidu final
+} t_valeurs;
+
+int lireRecompenses(const char *fichier, int n, double **recompenses, int *nb_recompenses);
+int calculerValeurs(liste_adjacence la, t_partition *p, int *vertex_to_class, t_link_array *liens,
+                    const double *recompenses, int nb_recompenses,
+                    const double *facteurs, int nb_facteurs,
+                    t_methode_valeur methode, double tolerance, int max_iter, t_valeurs *out);
+void libererValeurs(t_valeurs *v);
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "graph.h"
+#include "sparse.h"
+
+/*
+   Renumérotation des états pour la localité mémoire : les classes sont
+   rangées dans l'ordre topologique du graphe des classes (la matrice devient
+   triangulaire supérieure par blocs) et, à l'intérieur de chaque classe, les
+   sommets sont ordonnés par BFS ou Cuthill-McKee inverse (matrice en bande).
+*/
+typedef enum {
+    ORDRE_CLASSES,  // ordre topologique des classes, membres dans l'ordre de Tarjan
+    ORDRE_BFS,      // + parcours en largeur dans chaque classe
+    ORDRE_RCM       // + Cuthill-McKee inverse dans chaque classe
+} t_ordre;
+
+typedef struct {
+    int n;
+    int *nouveau_vers_ancien;  // [1..n] : sommet d'origine du nouveau numéro
+    int *ancien_vers_nouveau;  // [1..n] : nouveau numéro du sommet d'origine
+} t_permutation;
+
+int *ordreTopologiqueClasses(t_partition *p, t_link_array *liens);
+t_permutation calculerPermutation(liste_adjacence la, t_partition *p, t_link_array *liens, t_ordre ordre);
+liste_adjacence permuterGraphe(liste_adjacence la, t_permutation *perm);
+int *ordreLocalClasse(t_permutation *perm, t_classe *c);
+t_csr permuterCSR(t_csr *m, const int *ordre);
+void vecteurVersOriginal(t_permutation *perm, float *v_permute, float *v_original);
+void vecteurVersPermute(t_permutation *perm, float *v_original, float *v_permute);
+void libererPermutation(t_permutation *perm);
+
+int computeStationaryDistributionOrdonnee(liste_adjacence la, t_partition *p, t_link_array *liens,
+                                          t_ordre ordre, float *pi, float epsilon, int max_iter);
+
+#endif
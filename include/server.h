@@ -0,0 +1,27 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+/*
+   Mode serveur : les chaînes sont chargées une fois (libmarkov) et restent en
+   mémoire ; les requêtes arrivent sur un socket local (AF_UNIX) et sont
+   traitées par un groupe de threads. Les connexions inactives sont surveillées
+   par poll et ne retiennent aucun worker entre deux requêtes.
+
+   Protocole : une requête par ligne, une réponse par ligne ("OK ..." ou "ERR message").
+     PING
+     LOAD  <nom> <fichier>        -> OK <nb_etats> <nb_classes>   (fichier relatif au dossier de données)
+     LIST                         -> OK <nom> <nom> ...
+     CLASS <nom> <etat>           -> OK <classe> <persistante 0|1> <periode>
+     STAT  <nom> <etat>           -> OK <proba stationnaire>
+     DIST  <nom> <k> <etat>       -> OK <p_1> ... <p_n>   (loi après k pas depuis etat)
+     REACH <nom> <i> <j>          -> OK <0|1>
+*/
+#define SERVEUR_MAX_CHAINES 64
+#define SERVEUR_WORKERS_DEFAUT 4
+#define SERVEUR_CONNEXIONS_MAX 1024
+#define SERVEUR_DOSSIER_DEFAUT "data"
+
+int lancerServeur(const char *chemin_socket, int nb_workers, const char *dossier_donnees,
+                  char **fichiers, int nb_fichiers);
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include "graph.h"
+
+/*
+   Itération de puissance répartie sur plusieurs processus (shards) d'une
+   même machine. Le shard k possède une tranche [bornes[k], bornes[k+1]) des
+   états d'arrivée (lignes de la transposée, tranches de même nombre
+   d'arêtes) : il calcule ces composantes de pi * P en tirant les entrées dont
+   il a besoin du vecteur courant. Les deux vecteurs (courant / suivant) et
+   les écarts partiels vivent dans un segment de mémoire partagée POSIX ; une
+   barrière inter-processus sépare les itérations, et chaque shard décide de
+   l'arrêt à partir des mêmes écarts sommés dans le même ordre.
+
+   Quand la machine a plusieurs nœuds NUMA, le shard k est épinglé sur le
+   nœud k % nb_noeuds avant de construire sa tranche et de toucher sa partie
+   des vecteurs, pour que ces pages soient allouées localement.
+   Sous Windows, les shards sont des threads du même processus (pas de fork).
+*/
+#define SHARD_MAX 64
+
+int stationnaireShards(liste_adjacence la, float *pi, int nb_shards, float epsilon, int max_iter);
+
+#endif
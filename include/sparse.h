@@ -0,0 +1,32 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include "graph.h"
+
+/*
+   Matrice creuse au format CSR (lignes compressées), indices 0-based :
+   les arêtes du sommet i+1 sont colonnes[debut[i] .. debut[i+1]-1], triées
+   par colonne croissante, avec leurs probabilités dans valeurs[].
+*/
+typedef struct {
+    int n;
+    long nnz;
+    long *debut;     // n+1 entrées
+    int *colonnes;   // nnz entrées (sommet d'arrivée - 1)
+    float *valeurs;  // nnz entrées
+} t_csr;
+
+t_csr csrDepuisAdjacence(liste_adjacence la);
+void multiplyVectorCSR(float *vec, t_csr *m, float *out);
+t_csr transposerCSR(t_csr *m);
+void libererCSR(t_csr *m);
+void ressourceCSR(void *m);
+
+/* sous-chaînes par classe : blocs[i] est la restriction de la chaîne à la classe i
+   (arêtes internes seulement), l'état local r correspondant à members[r] */
+t_csr *extraireSousChaines(liste_adjacence la, t_partition *part, int *vertex_to_class);
+void libererSousChaines(t_csr *blocs, int nb);
+int periodeCSR(t_csr *m);
+float sommeLigneCSR(t_csr *m, int i);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef SPECTRAL_H
+#define SPECTRAL_H
+
+#include "graph.h"
+
+/*
+   Estimation du trou spectral par classe, pour prévoir le nombre
+   d'itérations des boucles M^n et p0 * S^k et choisir leur méthode
+   (précision, produit parallèle, boucle M^n inutile).
+   - classe fermée (stochastique) : module de la 2e valeur propre (SLEM),
+     obtenu par itération de puissance sur les vecteurs de somme nulle
+     (sous-espace invariant qui élimine la valeur propre 1) ;
+   - classe transitoire (sous-stochastique) : rayon spectral, la masse
+     restante décroît à ce taux.
+*/
+#define SPECTRE_ITER_DEFAUT 60
+
+typedef struct {
+    int fermee;                // 1 si aucune arête ne sort de la classe
+    float lambda;              // SLEM (fermée) ou rayon spectral (transitoire)
+    float temps_melange;       // 1 / (1 - lambda), -1 si lambda ~ 1
+    int iterations_estimees;   // itérations pour atteindre epsilon, -1 si pas de convergence
+} t_spectre;
+
+t_spectre estimerSpectreClasse(liste_adjacence la, t_partition *p, int *vertex_to_class,
+                               int compo_index, float epsilon, int nb_iter);
+int iterationsEstimees(float lambda, float epsilon);
+int borneIterations(int estimation, int plafond);
+
+#endif
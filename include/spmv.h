@@ -0,0 +1,46 @@
+#ifndef SPMV_H
+#define SPMV_H
+
+#include "graph.h"
+#include "sparse.h"
+#include "ordonnanceur.h"
+
+/*
+   Produit vecteur-matrice parallèle en mode "tiré" (pull).
+   out = vec * P s'écrit out[j] = somme des vec[i] * P[i][j] sur les arêtes
+   entrantes de j : avec la transposée de P, construite une fois et gardée
+   dans le t_spmv, chaque composante de out est calculée indépendamment.
+   Les états d'arrivée sont découpés en tranches contiguës de même nombre
+   d'arêtes (pas de même nombre d'états) ; chaque tâche écrit une plage
+   disjointe de out, sans atomique ni copie privée, et cumule au passage sa
+   part de l'écart L1 entre vec et out.
+
+   Le découpage ne dépend que de la matrice (environ SPMV_ARETES_TRANCHE
+   arêtes par tranche) et les écarts partiels sont sommés dans l'ordre des
+   tranches : le résultat est le même quel que soit le nombre de workers.
+   Sans ordonnanceur, ou sous SPMV_SEUIL_PARALLELE arêtes, les tranches sont
+   exécutées par le thread appelant.
+   Un t_spmv n'est jamais modifié par les produits : plusieurs threads peuvent
+   l'utiliser en même temps (vec et out distincts).
+*/
+#ifndef SPMV_SEUIL_PARALLELE
+#define SPMV_SEUIL_PARALLELE (1L << 15)
+#endif
+#define SPMV_ARETES_TRANCHE (1L << 13)
+#define SPMV_TRANCHES_MAX 1024
+
+typedef struct {
+    t_csr transposee;      // ligne j : arêtes entrantes de j, départs croissants
+    int nb_tranches;
+    int *bornes;           // nb_tranches + 1 : tranche t = arrivées [bornes[t], bornes[t+1])
+    t_ordonnanceur *o;     // NULL : exécution séquentielle
+} t_spmv;
+
+t_spmv creerSpmv(t_csr *m, t_ordonnanceur *o);
+t_spmv creerSpmvAdjacence(liste_adjacence la, t_ordonnanceur *o);
+float multiplierSpmv_f(const t_spmv *s, const float *vec, float *out);
+double multiplierSpmv_d(const t_spmv *s, const double *vec, double *out);
+void etapesSpmv(const t_spmv *s, float *p, int k);
+void libererSpmv(t_spmv *s);
+
+#endif
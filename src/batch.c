@@ -0,0 +1,516 @@
+#include "batch.h"
+#include "graph.h"
+#include "matrix.h"
+#include <stdint.h>
+#include <ctype.h>
+
+/*
+   Noyaux à taille fixe : N est une constante, les boucles sur i, j sont
+   déroulées par le compilateur et la boucle interne sur les chaînes est
+   vectorisée (aucune dépendance entre chaînes).
+*/
+#define NOYAUX_LOT(N)                                                              \
+static void etapeTuile##N(const float *restrict P, const float *restrict p,       \
+                          float *restrict q) {                                     \
+    for (int k = 0; k < (N) * LOT_LARGEUR; k++) q[k] = 0.0f;                       \
+    for (int i = 0; i < (N); i++) {                                                \
+        const float *pi = p + i * LOT_LARGEUR;                                     \
+        for (int j = 0; j < (N); j++) {                                            \
+            const float *pij = P + (i * (N) + j) * LOT_LARGEUR;                    \
+            float *qj = q + j * LOT_LARGEUR;                                       \
+            for (int c = 0; c < LOT_LARGEUR; c++) qj[c] += pi[c] * pij[c];         \
+        }                                                                          \
+    }                                                                              \
+}                                                                                  \
+static void produitTuile##N(const float *restrict A, const float *restrict B,      \
+                            float *restrict C) {                                   \
+    for (int k = 0; k < (N) * (N) * LOT_LARGEUR; k++) C[k] = 0.0f;                 \
+    for (int i = 0; i < (N); i++) {                                                \
+        for (int k = 0; k < (N); k++) {                                            \
+            const float *aik = A + (i * (N) + k) * LOT_LARGEUR;                    \
+            for (int j = 0; j < (N); j++) {                                        \
+                const float *bkj = B + (k * (N) + j) * LOT_LARGEUR;                \
+                float *cij = C + (i * (N) + j) * LOT_LARGEUR;                      \
+                for (int c = 0; c < LOT_LARGEUR; c++) cij[c] += aik[c] * bkj[c];   \
+            }                                                                      \
+        }                                                                          \
+    }                                                                              \
+}
+
+NOYAUX_LOT(4)
+NOYAUX_LOT(8)
+NOYAUX_LOT(16)
+NOYAUX_LOT(32)
+
+static void etapeTuile(int N, const float *P, const float *p, float *q) {
+    switch (N) {
+        case 4: etapeTuile4(P, p, q); break;
+        case 8: etapeTuile8(P, p, q); break;
+        case 16: etapeTuile16(P, p, q); break;
+        default: etapeTuile32(P, p, q); break;
+    }
+}
+
+static void produitTuile(int N, const float *A, const float *B, float *C) {
+    switch (N) {
+        case 4: produitTuile4(A, B, C); break;
+        case 8: produitTuile8(A, B, C); break;
+        case 16: produitTuile16(A, B, C); break;
+        default: produitTuile32(A, B, C); break;
+    }
+}
+
+/* plus petite taille de noyau pouvant contenir n états (0 si n > LOT_N_MAX) */
+int tailleNoyau(int n) {
+    if (n <= 0 || n > LOT_N_MAX) return 0;
+    if (n <= 4) return 4;
+    if (n <= 8) return 8;
+    if (n <= 16) return 16;
+    return 32;
+}
+
+t_tuile *creerTuile(int N) {
+    t_tuile *t = (t_tuile*)malloc(sizeof(t_tuile));
+    if (!t) erreurFatale("alloc tuile");
+    t->N = N;
+    t->P = (float*)malloc((size_t)N * N * LOT_LARGEUR * sizeof(float));
+    if (!t->P) erreurFatale("alloc tuile");
+    viderTuile(t);
+    return t;
+}
+
+void viderTuile(t_tuile *t) {
+    t->nb = 0;
+    memset(t->P, 0, (size_t)t->N * t->N * LOT_LARGEUR * sizeof(float));
+}
+
+/* range une chaîne dans la prochaine colonne libre ; renvoie son indice, -1 si la tuile est pleine
+   (arêtes hors intervalle ignorées, arêtes multiples additionnées) */
+int ajouterChaineTuile(t_tuile *t, int n, int m, const int *depart, const int *arrivee,
+                       const float *proba, int id) {
+    if (t->nb == LOT_LARGEUR || n > t->N) return -1;
+    int c = t->nb++;
+    t->taille[c] = n;
+    t->id[c] = id;
+    for (int e = 0; e < m; e++) {
+        if (depart[e] < 1 || depart[e] > n || arrivee[e] < 1 || arrivee[e] > n) continue;
+        t->P[((depart[e] - 1) * t->N + arrivee[e] - 1) * LOT_LARGEUR + c] += proba[e];
+    }
+    return c;
+}
+
+/* itère au plus 'etapes' fois les chaînes actives (actif[c] = 1) ; une chaîne
+   s'arrête quand elle converge ou atteint max_iter itérations au total */
+static void itererTuile(t_tuile *t, float *pi, float *actif, int *iterations,
+                        float epsilon, int max_iter, int etapes) {
+    int N = t->N;
+    float q[LOT_N_MAX * LOT_LARGEUR];
+    float d[LOT_LARGEUR];
+    int nb_actifs = 0;
+    for (int c = 0; c < t->nb; c++) {
+        if (actif[c] != 0.0f && iterations[c] >= max_iter) actif[c] = 0.0f;
+        if (actif[c] != 0.0f) nb_actifs++;
+    }
+    for (int s = 0; s < etapes && nb_actifs > 0; s++) {
+        etapeTuile(N, t->P, pi, q);
+        for (int c = 0; c < LOT_LARGEUR; c++) d[c] = 0.0f;
+        for (int i = 0; i < N; i++) {
+            float *p = pi + i * LOT_LARGEUR;
+            const float *r = q + i * LOT_LARGEUR;
+            for (int c = 0; c < LOT_LARGEUR; c++) {
+                d[c] += fabsf(p[c] - r[c]);
+                p[c] += actif[c] * (r[c] - p[c]);
+            }
+        }
+        for (int c = 0; c < t->nb; c++) {
+            if (actif[c] == 0.0f) continue;
+            iterations[c]++;
+            if (d[c] < epsilon || iterations[c] >= max_iter) {
+                actif[c] = 0.0f;
+                nb_actifs--;
+            }
+        }
+    }
+}
+
+/* distribution uniforme sur les états réels de chaque chaîne */
+static void initialiserUniforme(t_tuile *t, float *pi, float *actif, int *iterations) {
+    for (int c = 0; c < LOT_LARGEUR; c++) {
+        actif[c] = c < t->nb ? 1.0f : 0.0f;
+        iterations[c] = 0;
+    }
+    for (int i = 0; i < t->N; i++) {
+        for (int c = 0; c < LOT_LARGEUR; c++) {
+            pi[i * LOT_LARGEUR + c] = (c < t->nb && i < t->taille[c]) ? 1.0f / t->taille[c] : 0.0f;
+        }
+    }
+}
+
+/* stationnaireTuile
+ Itération de puissance de toutes les chaînes de la tuile en même temps, depuis
+ l'uniforme sur les états réels (mêmes critère et compte d'itérations que
+ computeStationaryDistributionFrom). Une chaîne convergée est figée par masque.
+ pi : N*LOT_LARGEUR (pi[i*LOT_LARGEUR + c]), iterations : LOT_LARGEUR.
+ */
+void stationnaireTuile(t_tuile *t, float *pi, float epsilon, int max_iter, int *iterations) {
+    float actif[LOT_LARGEUR];
+    initialiserUniforme(t, pi, actif, iterations);
+    itererTuile(t, pi, actif, iterations, epsilon, max_iter, max_iter);
+}
+
+/* Pk = P^k pour toutes les chaînes (exponentiation rapide), même disposition que P */
+void puissanceTuile(t_tuile *t, int k, float *Pk) {
+    int N = t->N;
+    size_t taille = (size_t)N * N * LOT_LARGEUR;
+    float *base = (float*)malloc(taille * sizeof(float));
+    float *tmp = (float*)malloc(taille * sizeof(float));
+    if (!base || !tmp) erreurFatale("alloc tuile");
+    memcpy(base, t->P, taille * sizeof(float));
+    memset(Pk, 0, taille * sizeof(float));
+    for (int i = 0; i < N; i++) {
+        for (int c = 0; c < LOT_LARGEUR; c++) Pk[(i * N + i) * LOT_LARGEUR + c] = 1.0f;
+    }
+    while (k > 0) {
+        if (k & 1) {
+            produitTuile(N, Pk, base, tmp);
+            memcpy(Pk, tmp, taille * sizeof(float));
+        }
+        k >>= 1;
+        if (k > 0) {
+            produitTuile(N, base, base, tmp);
+            memcpy(base, tmp, taille * sizeof(float));
+        }
+    }
+    free(base);
+    free(tmp);
+}
+
+/* periodeTuile
+ Période de chaque classe de chaque chaîne, calculée comme periodeCSR : parcours
+ en largeur à l'intérieur de la classe depuis son premier état et PGCD des
+ |niveau[u] + 1 - niveau[v]| sur ses arêtes. Les classes viennent de la
+ fermeture transitive, sur un masque de 32 bits par ligne.
+ periodes : N*LOT_LARGEUR, periodes[i*LOT_LARGEUR + c] = période de la classe de l'état i.
+ */
+void periodeTuile(t_tuile *t, int *periodes) {
+    int N = t->N;
+    for (int c = 0; c < t->nb; c++) {
+        int n = t->taille[c];
+        uint32_t A[LOT_N_MAX], R[LOT_N_MAX];
+        for (int i = 0; i < n; i++) {
+            A[i] = 0;
+            for (int j = 0; j < n; j++) {
+                if (t->P[(i * N + j) * LOT_LARGEUR + c] > 0.0f) A[i] |= (uint32_t)1 << j;
+            }
+            R[i] = A[i] | (uint32_t)1 << i;
+        }
+        /* R[i] : états atteignables depuis i (Warshall) */
+        for (int k = 0; k < n; k++) {
+            for (int i = 0; i < n; i++) {
+                if (R[i] & ((uint32_t)1 << k)) R[i] |= R[k];
+            }
+        }
+        uint32_t vus = 0;
+        for (int s = 0; s < n; s++) {
+            if (vus & ((uint32_t)1 << s)) continue;
+            uint32_t classe = 0;
+            for (int j = 0; j < n; j++) {
+                if ((R[s] & ((uint32_t)1 << j)) && (R[j] & ((uint32_t)1 << s))) classe |= (uint32_t)1 << j;
+            }
+            vus |= classe;
+            int niveau[LOT_N_MAX], file[LOT_N_MAX];
+            int debut = 0, fin = 0, periode = 0;
+            for (int j = 0; j < n; j++) niveau[j] = -1;
+            niveau[s] = 0;
+            file[fin++] = s;
+            while (debut < fin) {
+                int u = file[debut++];
+                for (uint32_t r = A[u] & classe; r; r &= r - 1) {
+                    int v = __builtin_ctz(r);
+                    if (niveau[v] == -1) {
+                        niveau[v] = niveau[u] + 1;
+                        file[fin++] = v;
+                    } else {
+                        int vals[2] = { periode, abs(niveau[u] + 1 - niveau[v]) };
+                        periode = gcd(vals, 2);
+                    }
+                }
+            }
+            for (uint32_t r = classe; r; r &= r - 1) {
+                periodes[__builtin_ctz(r) * LOT_LARGEUR + c] = periode;
+            }
+        }
+    }
+}
+
+void libererTuile(t_tuile *t) {
+    if (!t) return;
+    free(t->P);
+    free(t);
+}
+
+/* lit le prochain jeton (suite de caractères non blancs, 63 au plus) ;
+ *nouvelle_ligne : un saut de ligne le précède. Renvoie 0 en fin de fichier. */
+static int lireJeton(FILE *f, char *jeton, int *nouvelle_ligne) {
+    int c, nl = 0;
+    while ((c = fgetc(f)) != EOF && isspace(c)) {
+        if (c == '\n') nl = 1;
+    }
+    if (c == EOF) return 0;
+    ungetc(c, f);
+    *nouvelle_ligne = nl;
+    return fscanf(f, "%63s", jeton) == 1;
+}
+
+/* lireLot
+ Fichier de lot : chaînes au format de readGraph mises bout à bout ; un entier
+ seul sur sa ligne commence une nouvelle chaîne. Les arêtes
+ "depart arrivee proba" sont lues jeton par jeton, séparées par des
+ blancs quelconques (espaces, tabulations, sauts de ligne, sans limite de
+ longueur de ligne). Un fichier ordinaire est donc un lot d'une chaîne.
+ Renvoie le nombre de chaînes lues, -1 si le fichier est illisible.
+ */
+int lireLot(const char *fichier, t_rappel_chaine rappel, void *ctx) {
+    FILE *f = fopen(fichier, "rt");
+    if (!f) return -1;
+    int cap = 64, m = 0, n = 0, nb = 0;
+    int *dep = (int*)malloc(cap * sizeof(int));
+    int *arr = (int*)malloc(cap * sizeof(int));
+    float *pr = (float*)malloc(cap * sizeof(float));
+    if (!dep || !arr || !pr) erreurFatale("alloc lot");
+    char jetons[2][64];
+    int nouvelle_ligne[2];
+    int cour = 0;
+    int ok = lireJeton(f, jetons[0], &nouvelle_ligne[0]);
+    nouvelle_ligne[0] = 1;  // début du fichier
+    long sommets[2];
+    int k = 0;              // champs déjà lus de l'arête en cours
+    while (ok) {
+        int suiv = cour ^ 1;
+        int ok_suiv = lireJeton(f, jetons[suiv], &nouvelle_ligne[suiv]);
+        int seul = nouvelle_ligne[cour] && (!ok_suiv || nouvelle_ligne[suiv]);
+        char *j = jetons[cour], *fin;
+        if (k == 0 && seul) {                    // en-tête : nouvelle chaîne
+            long v = strtol(j, &fin, 10);
+            if (fin != j && *fin == '\0') {
+                if (n > 0) {
+                    rappel(ctx, n, m, dep, arr, pr);
+                    nb++;
+                }
+                n = (int)v;
+                m = 0;
+            }
+        } else if (k < 2) {
+            long v = strtol(j, &fin, 10);
+            if (fin != j && *fin == '\0') sommets[k++] = v;
+            else k = 0;                          // jeton invalide : arête abandonnée
+        } else {
+            float proba = strtof(j, &fin);
+            k = 0;
+            if (fin != j && *fin == '\0' && n > 0) {
+                if (m == cap) {
+                    cap *= 2;
+                    int *d2 = (int*)realloc(dep, cap * sizeof(int));
+                    int *a2 = (int*)realloc(arr, cap * sizeof(int));
+                    float *p2 = (float*)realloc(pr, cap * sizeof(float));
+                    if (!d2 || !a2 || !p2) erreurFatale("alloc lot");
+                    dep = d2;
+                    arr = a2;
+                    pr = p2;
+                }
+                dep[m] = (int)sommets[0];
+                arr[m] = (int)sommets[1];
+                pr[m] = proba;
+                m++;
+            }
+        }
+        cour = suiv;
+        ok = ok_suiv;
+    }
+    if (n > 0) {
+        rappel(ctx, n, m, dep, arr, pr);
+        nb++;
+    }
+    fclose(f);
+    free(dep);
+    free(arr);
+    free(pr);
+    return nb;
+}
+
+/* résultats par chaîne, rangés dans l'ordre du fichier */
+typedef struct {
+    int n;
+    int iterations;
+    long offset;          // dans les tableaux pi et periodes (-1 : chaîne trop grande)
+} t_resultat_lot;
+
+/* tuile de chaînes lentes à converger, regroupées pour ne pas bloquer les autres */
+typedef struct {
+    t_tuile *tuile;
+    float pi[LOT_N_MAX * LOT_LARGEUR];
+    float actif[LOT_LARGEUR];
+    int iterations[LOT_LARGEUR];
+} t_retardataires;
+
+typedef struct {
+    t_tuile *tuiles[4];   // N = 4, 8, 16, 32
+    t_retardataires ret[4];
+    t_resultat_lot *res;
+    int nb, cap;
+    float *pi;
+    int *periodes;        // période de la classe de chaque état, mêmes offsets que pi
+    long nb_pi, cap_pi;
+    float epsilon;
+    int max_iter;
+} t_lot;
+
+static int indiceNoyau(int N) {
+    return N == 4 ? 0 : N == 8 ? 1 : N == 16 ? 2 : 3;
+}
+
+/* range le résultat de la colonne c */
+static void rangerResultat(t_lot *l, t_tuile *t, const float *pi, int c, int iterations) {
+    t_resultat_lot *r = &l->res[t->id[c]];
+    r->iterations = iterations;
+    for (int i = 0; i < t->taille[c]; i++) {
+        l->pi[r->offset + i] = pi[i * LOT_LARGEUR + c];
+    }
+}
+
+/* termine les retardataires (jusqu'à max_iter) et range leurs résultats */
+static void finirRetardataires(t_lot *l, t_retardataires *r) {
+    t_tuile *t = r->tuile;
+    if (t->nb == 0) return;
+    itererTuile(t, r->pi, r->actif, r->iterations, l->epsilon, l->max_iter, l->max_iter);
+    for (int c = 0; c < t->nb; c++) rangerResultat(l, t, r->pi, c, r->iterations[c]);
+    viderTuile(t);
+}
+
+/* traiterTuile
+ Calcule les périodes d'une tuile pleine (ou de la dernière), puis LOT_ETAPES
+ itérations de puissance ; les chaînes non convergées sont déplacées, avec leur
+ vecteur courant, dans la tuile des retardataires de même taille. Sans cela une
+ seule chaîne périodique ferait tourner toute la tuile jusqu'à max_iter.
+ */
+static void traiterTuile(t_lot *l, t_tuile *t) {
+    float pi[LOT_N_MAX * LOT_LARGEUR];
+    float actif[LOT_LARGEUR];
+    int iterations[LOT_LARGEUR];
+    int periodes[LOT_N_MAX * LOT_LARGEUR];
+    if (t->nb == 0) return;
+    periodeTuile(t, periodes);
+    initialiserUniforme(t, pi, actif, iterations);
+    itererTuile(t, pi, actif, iterations, l->epsilon, l->max_iter, LOT_ETAPES);
+    t_retardataires *r = &l->ret[indiceNoyau(t->N)];
+    int N = t->N;
+    for (int c = 0; c < t->nb; c++) {
+        t_resultat_lot *res = &l->res[t->id[c]];
+        for (int i = 0; i < t->taille[c]; i++) l->periodes[res->offset + i] = periodes[i * LOT_LARGEUR + c];
+        if (actif[c] == 0.0f) {
+            rangerResultat(l, t, pi, c, iterations[c]);
+            continue;
+        }
+        t_tuile *rt = r->tuile;
+        int k = rt->nb++;
+        rt->taille[k] = t->taille[c];
+        rt->id[k] = t->id[c];
+        for (int e = 0; e < N * N; e++) rt->P[e * LOT_LARGEUR + k] = t->P[e * LOT_LARGEUR + c];
+        for (int i = 0; i < N; i++) r->pi[i * LOT_LARGEUR + k] = pi[i * LOT_LARGEUR + c];
+        r->actif[k] = 1.0f;
+        r->iterations[k] = iterations[c];
+        if (rt->nb == LOT_LARGEUR) finirRetardataires(l, r);
+    }
+    viderTuile(t);
+}
+
+static void ajouterChaineLot(void *ctx, int n, int m, const int *depart, const int *arrivee,
+                             const float *proba) {
+    t_lot *l = (t_lot*)ctx;
+    if (l->nb == l->cap) {
+        l->cap *= 2;
+        t_resultat_lot *r = (t_resultat_lot*)realloc(l->res, l->cap * sizeof(t_resultat_lot));
+        if (!r) erreurFatale("alloc lot");
+        l->res = r;
+    }
+    int id = l->nb++;
+    t_resultat_lot *r = &l->res[id];
+    r->n = n;
+    r->iterations = 0;
+    r->offset = -1;
+    int N = tailleNoyau(n);
+    if (N == 0) return;
+    if (l->nb_pi + n > l->cap_pi) {
+        while (l->nb_pi + n > l->cap_pi) l->cap_pi *= 2;
+        float *p = (float*)realloc(l->pi, l->cap_pi * sizeof(float));
+        if (!p) erreurFatale("alloc lot");
+        l->pi = p;
+        int *q = (int*)realloc(l->periodes, l->cap_pi * sizeof(int));
+        if (!q) erreurFatale("alloc lot");
+        l->periodes = q;
+    }
+    r->offset = l->nb_pi;
+    l->nb_pi += n;
+    t_tuile *t = l->tuiles[indiceNoyau(N)];
+    ajouterChaineTuile(t, n, m, depart, arrivee, proba, id);
+    if (t->nb == LOT_LARGEUR) traiterTuile(l, t);
+}
+
+/* analyserLot
+ Lit un fichier de lot, calcule les périodes (par classe) et la distribution
+ stationnaire de chaque chaîne et les écrit dans 'out' dans l'ordre du fichier. Les chaînes de plus de
+ LOT_N_MAX états sont signalées et ignorées. Renvoie le nombre de chaînes, -1
+ si le fichier est illisible.
+ */
+int analyserLot(const char *fichier, FILE *out, float epsilon, int max_iter) {
+    t_lot l;
+    int tailles[4] = { 4, 8, 16, 32 };
+    for (int k = 0; k < 4; k++) {
+        l.tuiles[k] = creerTuile(tailles[k]);
+        l.ret[k].tuile = creerTuile(tailles[k]);
+    }
+    l.cap = 1024;
+    l.nb = 0;
+    l.res = (t_resultat_lot*)malloc(l.cap * sizeof(t_resultat_lot));
+    l.cap_pi = 8192;
+    l.nb_pi = 0;
+    l.pi = (float*)malloc(l.cap_pi * sizeof(float));
+    l.periodes = (int*)malloc(l.cap_pi * sizeof(int));
+    l.epsilon = epsilon;
+    l.max_iter = max_iter;
+    if (!l.res || !l.pi || !l.periodes) erreurFatale("alloc lot");
+
+    int nb = lireLot(fichier, ajouterChaineLot, &l);
+    for (int k = 0; k < 4; k++) {
+        traiterTuile(&l, l.tuiles[k]);
+        finirRetardataires(&l, &l.ret[k]);
+    }
+    for (int c = 0; nb > 0 && c < l.nb; c++) {
+        t_resultat_lot *r = &l.res[c];
+        if (r->offset < 0) {
+            fprintf(out, "Chaîne %d : %d états, trop grande pour le mode lot (max %d)\n", c + 1, r->n, LOT_N_MAX);
+            continue;
+        }
+        /* une période si toutes les classes l'ont en commun, sinon celle de chaque état */
+        const int *per = l.periodes + r->offset;
+        int commune = 1;
+        for (int i = 1; i < r->n; i++) commune = commune && per[i] == per[0];
+        if (commune) {
+            fprintf(out, "Chaîne %d : %d états, période %d, it=%d :", c + 1, r->n, per[0], r->iterations);
+        } else {
+            fprintf(out, "Chaîne %d : %d états, périodes par état", c + 1, r->n);
+            for (int i = 0; i < r->n; i++) fprintf(out, " %d", per[i]);
+            fprintf(out, ", it=%d :", r->iterations);
+        }
+        for (int i = 0; i < r->n; i++) fprintf(out, " %.6f", l.pi[r->offset + i]);
+        fprintf(out, "\n");
+    }
+    for (int k = 0; k < 4; k++) {
+        libererTuile(l.tuiles[k]);
+        libererTuile(l.ret[k].tuile);
+    }
+    free(l.res);
+    free(l.pi);
+    free(l.periodes);
+    return nb;
+}
@@ -0,0 +1,212 @@
+#include "cache.h"
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <direct.h>
+#define creerDossier(d) _mkdir(d)
+#else
+#define creerDossier(d) mkdir(d, 0755)
+#endif
+
+#define CACHE_MAGIC   0x314B434DU  // "MCK1"
+#define FNV_OFFSET    1469598103934665603ULL
+#define FNV_PRIME     1099511628211ULL
+
+typedef struct {
+    int arrivee;
+    float proba;
+} t_arc;
+
+static unsigned long long fnv1a(unsigned long long h, const void *data, size_t len) {
+    const unsigned char *p = (const unsigned char *)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+static int comparerArcs(const void *a, const void *b) {
+    const t_arc *x = (const t_arc *)a;
+    const t_arc *y = (const t_arc *)b;
+    return (x->arrivee > y->arrivee) - (x->arrivee < y->arrivee);
+}
+
+/* calculerEmpreinte
+ Les arêtes de chaque sommet sont triées par arrivée pour que l'ordre des
+ lignes du fichier n'influe pas sur l'empreinte. L'empreinte 'topologie'
+ ignore les probabilités (elle reste valable après un changement de poids).
+ */
+t_empreinte calculerEmpreinte(liste_adjacence la) {
+    t_empreinte e;
+    e.complet = fnv1a(FNV_OFFSET, &la.taille, sizeof(int));
+    e.topologie = e.complet;
+    int cap = 16;
+    t_arc *arcs = (t_arc *)malloc(cap * sizeof(t_arc));
+    if (!arcs) { erreurFatale("alloc calculerEmpreinte"); }
+    for (int i = 0; i < la.taille; i++) {
+        int nb = 0;
+        cellule *tmp = la.tab[i].head;
+        while (tmp) {
+            if (nb >= cap) {
+                cap *= 2;
+                arcs = (t_arc *)realloc(arcs, cap * sizeof(t_arc));
+                if (!arcs) { erreurFatale("alloc calculerEmpreinte"); }
+            }
+            arcs[nb].arrivee = tmp->arrivee;
+            arcs[nb].proba = tmp->proba;
+            nb++;
+            tmp = tmp->suivant;
+        }
+        qsort(arcs, nb, sizeof(t_arc), comparerArcs);
+        int depart = i + 1;
+        e.complet = fnv1a(e.complet, &depart, sizeof(int));
+        e.topologie = fnv1a(e.topologie, &depart, sizeof(int));
+        for (int k = 0; k < nb; k++) {
+            e.complet = fnv1a(e.complet, &arcs[k].arrivee, sizeof(int));
+            e.complet = fnv1a(e.complet, &arcs[k].proba, sizeof(float));
+            e.topologie = fnv1a(e.topologie, &arcs[k].arrivee, sizeof(int));
+        }
+    }
+    free(arcs);
+    return e;
+}
+
+static void cheminCache(char *buf, size_t len, const char *dossier, t_empreinte e) {
+    snprintf(buf, len, "%s/%016llx.mkc", dossier, e.topologie);
+}
+
+/* chargerCache
+ Cherche le fichier associé à l'empreinte topologique. Renvoie CACHE_ABSENT,
+ CACHE_TOPOLOGIE ou CACHE_COMPLET et remplit r dans les deux derniers cas
+ (à libérer avec libererResultatCache).
+ */
+int chargerCache(const char *dossier, t_empreinte e, int n, t_resultat_cache *r) {
+    char path[512];
+    cheminCache(path, sizeof(path), dossier, e);
+    FILE *f = fopen(path, "rb");
+    if (!f) return CACHE_ABSENT;
+
+    unsigned int magic;
+    unsigned long long complet, topologie;
+    int nf, nb_classes;
+    if (fread(&magic, sizeof(magic), 1, f) != 1 || magic != CACHE_MAGIC ||
+        fread(&complet, sizeof(complet), 1, f) != 1 ||
+        fread(&topologie, sizeof(topologie), 1, f) != 1 ||
+        fread(&nf, sizeof(int), 1, f) != 1 ||
+        fread(&nb_classes, sizeof(int), 1, f) != 1 ||
+        topologie != e.topologie || nf != n || nb_classes <= 0) {
+        fclose(f);
+        return CACHE_ABSENT;
+    }
+
+    r->n = n;
+    r->periodes = NULL;
+    r->stationnaire = NULL;
+    init_partition(&r->partition);
+    init_link_array(&r->hasse);
+    /* un fichier tronqué ou corrompu est rejeté : chaque état dans exactement
+       une classe, extrémités des liens dans 1..nb_classes */
+    int ok = 1;
+    int nb_membres = 0;
+    char *vu = (char*)calloc(n + 1, 1);
+    if (!vu) erreurFatale("alloc cache");
+    for (int i = 0; i < nb_classes && ok; i++) {
+        int size;
+        char name[16];
+        if (fread(&size, sizeof(int), 1, f) != 1 || size <= 0 || size > n - nb_membres) { ok = 0; break; }
+        t_classe c;
+        snprintf(name, sizeof(name), "C%d", i + 1);
+        init_classe(&c, name);
+        for (int j = 0; j < size; j++) {
+            int v;
+            if (fread(&v, sizeof(int), 1, f) != 1 || v < 1 || v > n || vu[v]) { ok = 0; break; }
+            vu[v] = 1;
+            add_member_to_classe(&c, v);
+        }
+        nb_membres += size;
+        add_class(&r->partition, c);
+    }
+    free(vu);
+    if (nb_membres != n) ok = 0;
+    int nb_liens = 0;
+    if (ok && (fread(&nb_liens, sizeof(int), 1, f) != 1 || nb_liens < 0)) ok = 0;
+    for (int k = 0; k < nb_liens && ok; k++) {
+        t_link l;
+        if (fread(&l, sizeof(t_link), 1, f) != 1 ||
+            l.from < 1 || l.from > nb_classes || l.to < 1 || l.to > nb_classes) { ok = 0; break; }
+        add_link_if_not_exists(&r->hasse, l.from, l.to);
+    }
+    if (ok) {
+        r->periodes = (int *)malloc(nb_classes * sizeof(int));
+        if (!r->periodes) { erreurFatale("alloc periodes"); }
+        if (fread(r->periodes, sizeof(int), nb_classes, f) != (size_t)nb_classes) ok = 0;
+    }
+    int a_stationnaire = 0;
+    if (ok && fread(&a_stationnaire, sizeof(int), 1, f) != 1) ok = 0;
+    if (ok && a_stationnaire) {
+        r->stationnaire = (float *)malloc(n * sizeof(float));
+        if (!r->stationnaire) { erreurFatale("alloc stationnaire"); }
+        if (fread(r->stationnaire, sizeof(float), n, f) != (size_t)n) ok = 0;
+    }
+    fclose(f);
+    if (!ok) {
+        libererResultatCache(r);
+        return CACHE_ABSENT;
+    }
+    return complet == e.complet ? CACHE_COMPLET : CACHE_TOPOLOGIE;
+}
+
+/* sauverCache
+ Écrit (ou remplace) l'entrée du cache pour cette empreinte. Renvoie 0 en cas
+ de succès, -1 sinon (le cache n'est qu'une optimisation : l'échec n'est pas fatal).
+ */
+int sauverCache(const char *dossier, t_empreinte e, t_resultat_cache *r) {
+    creerDossier(dossier);
+    char path[512], tmp_path[520];
+    cheminCache(path, sizeof(path), dossier, e);
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE *f = fopen(tmp_path, "wb");
+    if (!f) return -1;
+
+    unsigned int magic = CACHE_MAGIC;
+    int nb = r->partition.nb;
+    int a_stationnaire = r->stationnaire != NULL;
+    fwrite(&magic, sizeof(magic), 1, f);
+    fwrite(&e.complet, sizeof(e.complet), 1, f);
+    fwrite(&e.topologie, sizeof(e.topologie), 1, f);
+    fwrite(&r->n, sizeof(int), 1, f);
+    fwrite(&nb, sizeof(int), 1, f);
+    for (int i = 0; i < nb; i++) {
+        fwrite(&r->partition.classes[i].size, sizeof(int), 1, f);
+        fwrite(r->partition.classes[i].members, sizeof(int), r->partition.classes[i].size, f);
+    }
+    fwrite(&r->hasse.size, sizeof(int), 1, f);
+    fwrite(r->hasse.links, sizeof(t_link), r->hasse.size, f);
+    fwrite(r->periodes, sizeof(int), nb, f);
+    fwrite(&a_stationnaire, sizeof(int), 1, f);
+    if (a_stationnaire) fwrite(r->stationnaire, sizeof(float), r->n, f);
+    int err = ferror(f);
+    fclose(f);
+    if (err) {
+        remove(tmp_path);
+        return -1;
+    }
+    /* remplacement atomique pour ne jamais laisser une entrée tronquée */
+    remove(path);
+    if (rename(tmp_path, path) != 0) {
+        remove(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+/* libère un résultat chargé depuis le cache */
+void libererResultatCache(t_resultat_cache *r) {
+    if (!r) return;
+    free_partition(&r->partition);
+    free_link_array(&r->hasse);
+    free(r->periodes);
+    r->periodes = NULL;
+    free(r->stationnaire);
+    r->stationnaire = NULL;
+}
@@ -0,0 +1,219 @@
+#include "classes.h"
+#include "matrix.h"
+#include "precision.h"
+#include <stdarg.h>
+
+static void sortieAjouter(t_sortie *s, const char *fmt, ...) {
+    for (;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        int k = vsnprintf(s->texte + s->len, s->cap - s->len, fmt, ap);
+        va_end(ap);
+        if (k < 0) return;
+        if (s->len + (size_t)k < s->cap) {
+            s->len += k;
+            return;
+        }
+        size_t cap = s->cap * 2 + k + 1;
+        char *t = (char*)realloc(s->texte, cap);
+        if (!t) erreurFatale("alloc sortie");
+        s->texte = t;
+        s->cap = cap;
+    }
+}
+
+/* tâche : spectre d'une classe */
+typedef struct {
+    liste_adjacence la;
+    t_partition *p;
+    int *vertex_to_class;
+    float epsilon;
+    t_spectre *spectres;
+    int classe;
+} t_tache_spectre;
+
+static void tacheSpectre(void *arg) {
+    t_tache_spectre *t = (t_tache_spectre*)arg;
+    t->spectres[t->classe] = estimerSpectreClasse(t->la, t->p, t->vertex_to_class, t->classe,
+                                                  t->epsilon, SPECTRE_ITER_DEFAUT);
+}
+
+/* estimations spectrales de toutes les classes (résultats rangés par indice de classe) */
+void estimerSpectres(t_ordonnanceur *o, liste_adjacence la, t_partition *p, int *vertex_to_class,
+                     float epsilon, t_spectre *spectres) {
+    t_tache_spectre *taches = (t_tache_spectre*)malloc((p->nb + 1) * sizeof(t_tache_spectre));
+    if (!taches) erreurFatale("alloc spectres");
+    t_groupe g;
+    initGroupe(&g);
+    for (int i = 0; i < p->nb; i++) {
+        taches[i].la = la;
+        taches[i].p = p;
+        taches[i].vertex_to_class = vertex_to_class;
+        taches[i].epsilon = epsilon;
+        taches[i].spectres = spectres;
+        taches[i].classe = i;
+        soumettreTache(o, &g, tacheSpectre, &taches[i]);
+    }
+    attendreGroupe(o, &g);
+    free(taches);
+}
+
+/* tâche : analyse complète d'une classe, texte dans sa sortie */
+typedef struct {
+    t_ordonnanceur *o;
+    t_contexte_classes *ctx;
+    t_sortie *sortie;
+    int classe;
+} t_tache_classe;
+
+static void afficherBloc(t_sortie *s, t_csr *m) {
+    for (int i = 0; i < m->n; i++) {
+        long k = m->debut[i];
+        for (int j = 0; j < m->n; j++) {
+            float v = 0.0f;
+            while (k < m->debut[i + 1] && m->colonnes[k] == j) v += m->valeurs[k++];
+            sortieAjouter(s, "%.2f ", v);
+        }
+        sortieAjouter(s, "\n");
+    }
+}
+
+static void tacheClasse(void *arg) {
+    t_tache_classe *t = (t_tache_classe*)arg;
+    t_contexte_classes *ctx = t->ctx;
+    t_partition *partition = ctx->partition;
+    t_sortie *out = t->sortie;
+    int i = t->classe;
+    t_csr *sc = &ctx->sous_chaines[i];
+
+    sortieAjouter(out, "\n=== Sous-matrice pour la classe %s ===\n", partition->classes[i].name);
+    afficherBloc(out, sc);
+    sortieAjouter(out, "Période de la classe %s: %d\n", partition->classes[i].name, ctx->periodes[i]);
+
+    /* sommes des lignes de la sous-matrice (vérifier stochastique ou non) */
+    sortieAjouter(out, "Sommes des lignes de la sous-matrice (par état dans la classe) :\n");
+    for (int r = 0; r < sc->n; r++) {
+        float s = sommeLigneCSR(sc, r);
+        const char *status;
+        if (s > 0.999f && s < 1.001f) {
+            status = "(stochastique)";
+        } else if (s < 0.999f) {
+            status = "(sous-stochastique: masse sortante possible)";
+        } else {
+            status = "(>1 erreur?)";
+        }
+        sortieAjouter(out, "  Etat %d (dans classe) : somme = %.6f %s\n",
+                      partition->classes[i].members[r], s, status);
+    }
+
+    /* limite p0 * S^k pour p0 uniforme sur la classe (même pour classes transitoires) */
+    int m = sc->n;
+    if (m > 0) {
+        float *pcur = createZeroVector(m);
+        for (int k = 0; k < m; k++) pcur[k] = 1.0f / m;
+        int plafond = 100000;
+        /* l'estimation spectrale choisit la méthode : précision (le float ne
+           peut pas atteindre epsilon sur une classe lente) et produit tiré
+           parallèle si le travail attendu (arêtes x itérations estimées) est
+           grand ; l'arrêt reste sur epsilon, dans la limite du plafond */
+        t_spectre *sp = &ctx->spectres[i];
+        t_precision prec = precisionPourSpectre(ctx->precision, sp->temps_melange, m, ctx->epsilon);
+        int it = 0;
+        /* bloc renuméroté (ordre de la permutation globale) : p0 uniforme est
+           invariant, seul le résultat est remis dans l'ordre des membres */
+        int *ordre = NULL;
+        t_csr bloc = *sc;
+        if (ctx->permutation) {
+            ordre = ordreLocalClasse(ctx->permutation, &partition->classes[i]);
+            bloc = permuterCSR(sc, ordre);
+        }
+        double travail = (double)bloc.nnz * borneIterations(sp->iterations_estimees, plafond);
+        if (bloc.nnz >= CLASSE_SEUIL_PARALLELE || travail >= CLASSE_TRAVAIL_PARALLELE) {
+            /* grosse classe : produit tiré sur la transposée du bloc, découpé en sous-tâches */
+            t_spmv produit = creerSpmv(&bloc, t->o);
+            it = puissanceSpmv(&produit, pcur, ctx->epsilon, plafond, prec);
+            libererSpmv(&produit);
+        } else {
+            it = puissanceCSR(&bloc, pcur, ctx->epsilon, plafond, prec);
+        }
+        if (ordre) {
+            float *q = createZeroVector(m);
+            for (int k = 0; k < m; k++) q[ordre[k]] = pcur[k];
+            freeVector(pcur);
+            pcur = q;
+            libererCSR(&bloc);
+            free(ordre);
+        }
+        float mass = 0.0f;
+        for (int k = 0; k < m; k++) mass += pcur[k];
+        // stochastique signifie que la somme des composantes doit être 1(prochement), ce qui permet de savoir si la classe est fermée ou non
+        sortieAjouter(out, "Limite (approx) pour p0 uniforme sur la classe (it=%d) : somme des composantes = %.8f\n", it, mass);
+        for (int k = 0; k < m; k++) {
+            sortieAjouter(out, "  Etat %d : %.8f\n", partition->classes[i].members[k], pcur[k]);
+        }
+        freeVector(pcur);
+    }
+    /* persistante si pas de flèche sortante dans le Hasse réduit */
+    if (compute_caracteristics(partition, ctx->hasse, i + 1) == 0) {
+        sortieAjouter(out, "-> La classe %s est persistante.\n", partition->classes[i].name);
+    } else {
+        sortieAjouter(out, "-> La classe %s est transitoire.\n", partition->classes[i].name);
+    }
+}
+
+typedef struct {
+    long taille;
+    int classe;
+} t_cle_classe;
+
+/* décroissant en taille, puis par indice (ordre reproductible) */
+static int comparerTaille(const void *a, const void *b) {
+    const t_cle_classe *x = (const t_cle_classe*)a;
+    const t_cle_classe *y = (const t_cle_classe*)b;
+    if (x->taille != y->taille) return x->taille < y->taille ? 1 : -1;
+    return x->classe - y->classe;
+}
+
+/* analyserClasses
+ Renvoie un tableau de partition->nb sorties (dans l'ordre des classes) à
+ afficher par l'appelant puis libérer avec libererSorties.
+ */
+t_sortie *analyserClasses(t_ordonnanceur *o, t_contexte_classes *ctx) {
+    int nb = ctx->partition->nb;
+    t_sortie *sorties = (t_sortie*)calloc(nb + 1, sizeof(t_sortie));
+    t_tache_classe *taches = (t_tache_classe*)malloc((nb + 1) * sizeof(t_tache_classe));
+    t_cle_classe *ordre = (t_cle_classe*)malloc((nb + 1) * sizeof(t_cle_classe));
+    if (!sorties || !taches || !ordre) erreurFatale("alloc analyse classes");
+    for (int i = 0; i < nb; i++) {
+        ordre[i].taille = ctx->sous_chaines[i].nnz + ctx->sous_chaines[i].n;
+        ordre[i].classe = i;
+    }
+    qsort(ordre, nb, sizeof(t_cle_classe), comparerTaille);
+
+    /* soumises des plus grosses aux plus petites : les voleurs prennent par le
+       début de la file (les plus grosses d'abord), le thread appelant par la fin */
+    t_groupe g;
+    initGroupe(&g);
+    for (int k = 0; k < nb; k++) {
+        int i = ordre[k].classe;
+        sorties[i].cap = 256;
+        sorties[i].texte = (char*)malloc(sorties[i].cap);
+        if (!sorties[i].texte) erreurFatale("alloc sortie");
+        sorties[i].texte[0] = '\0';
+        taches[i].o = o;
+        taches[i].ctx = ctx;
+        taches[i].sortie = &sorties[i];
+        taches[i].classe = i;
+        soumettreTache(o, &g, tacheClasse, &taches[i]);
+    }
+    attendreGroupe(o, &g);
+    free(ordre);
+    free(taches);
+    return sorties;
+}
+
+void libererSorties(t_sortie *sorties, int nb) {
+    if (!sorties) return;
+    for (int i = 0; i < nb; i++) free(sorties[i].texte);
+    free(sorties);
+}
@@ -0,0 +1,412 @@
+#include "compact.h"
+#include "matrix.h"
+#include "outofcore.h"
+
+/* écrit v en varint (7 bits par octet), renvoie le nombre d'octets */
+static int ecrireVarint(uint8_t *dst, uint32_t v) {
+    int k = 0;
+    while (v >= 0x80) {
+        dst[k++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    dst[k++] = (uint8_t)v;
+    return k;
+}
+
+static int tailleVarint(uint32_t v) {
+    int k = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        k++;
+    }
+    return k;
+}
+
+static int comparerFloats(const void *a, const void *b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    double reste;
+    long k;
+} t_reste;
+
+/* restes décroissants, puis indice croissant (départage reproductible) */
+static int comparerRestes(const void *a, const void *b) {
+    const t_reste *x = (const t_reste*)a, *y = (const t_reste*)b;
+    if (x->reste != y->reste) return x->reste < y->reste ? 1 : -1;
+    return (x->k > y->k) - (x->k < y->k);
+}
+
+/* quantification 16 bits d'une ligne par la méthode des plus forts restes :
+ la somme quantifiée est la somme d'origine arrondie et chaque arête reste à
+ moins d'un quantum (1/65535) de sa valeur. Les restes sont triés une fois
+ (tmp : deg cases fournies par l'appelant), O(deg log deg). */
+static void quantifierLigne(const float *p, uint16_t *q, long deg, t_reste *tmp, float *erreur_max) {
+    if (deg == 0) return;
+    long somme_q = 0;
+    double somme = 0.0;
+    long nb = 0;
+    for (long k = 0; k < deg; k++) {
+        double x = p[k] < 0.0f ? 0.0 : (p[k] > 1.0f ? 1.0 : p[k]);
+        q[k] = (uint16_t)floor(x * 65535.0);
+        somme_q += q[k];
+        somme += x;
+        if (q[k] < 65535) {
+            tmp[nb].reste = x * 65535.0 - q[k];
+            tmp[nb].k = k;
+            nb++;
+        }
+    }
+    long reste = lround(somme * 65535.0) - somme_q;
+    /* les quanta manquants vont aux plus grands restes (reste <= deg) */
+    if (reste > 0) {
+        qsort(tmp, nb, sizeof(t_reste), comparerRestes);
+        for (long r = 0; r < reste && r < nb; r++) q[tmp[r].k]++;
+    }
+    for (long k = 0; k < deg; k++) {
+        float e = fabsf(q[k] / 65535.0f - p[k]);
+        if (e > *erreur_max) *erreur_max = e;
+    }
+}
+
+/* compresserGraphe
+ Construit la version compacte d'une CSR (lignes triées). En mode
+ dictionnaire, si plus de 65536 valeurs distinctes existent, on revient à la
+ virgule fixe 16 bits. erreur_max indique l'erreur d'arrondi effective.
+ */
+t_graphe_compact compresserGraphe(t_csr *m, t_mode_compact mode) {
+    t_graphe_compact g;
+    g.n = m->n;
+    g.nnz = m->nnz;
+    g.dictionnaire = NULL;
+    g.taille_dictionnaire = 0;
+    g.erreur_max = 0.0f;
+    g.debut_octets = (uint64_t*)malloc((g.n + 1) * sizeof(uint64_t));
+    g.debut_aretes = (uint64_t*)malloc((g.n + 1) * sizeof(uint64_t));
+    g.probas = (uint16_t*)malloc((g.nnz + 1) * sizeof(uint16_t));
+    if (!g.debut_octets || !g.debut_aretes || !g.probas) erreurFatale("alloc graphe compact");
+
+    /* taille exacte du flux de colonnes */
+    uint64_t total = 0;
+    for (int i = 0; i < g.n; i++) {
+        int prec = 0;
+        for (long k = m->debut[i]; k < m->debut[i + 1]; k++) {
+            total += tailleVarint((uint32_t)(m->colonnes[k] - prec));
+            prec = m->colonnes[k];
+        }
+    }
+    g.colonnes = (uint8_t*)malloc(total + 1);
+    if (!g.colonnes) erreurFatale("alloc graphe compact");
+    uint64_t pos = 0;
+    for (int i = 0; i < g.n; i++) {
+        g.debut_octets[i] = pos;
+        g.debut_aretes[i] = (uint64_t)m->debut[i];
+        int prec = 0;
+        for (long k = m->debut[i]; k < m->debut[i + 1]; k++) {
+            pos += ecrireVarint(g.colonnes + pos, (uint32_t)(m->colonnes[k] - prec));
+            prec = m->colonnes[k];
+        }
+    }
+    g.debut_octets[g.n] = pos;
+    g.debut_aretes[g.n] = (uint64_t)g.nnz;
+
+    if (mode == COMPACT_DICTIONNAIRE) {
+        float *tri = (float*)malloc((g.nnz + 1) * sizeof(float));
+        if (!tri) erreurFatale("alloc dictionnaire");
+        memcpy(tri, m->valeurs, g.nnz * sizeof(float));
+        qsort(tri, g.nnz, sizeof(float), comparerFloats);
+        long nb = 0;
+        for (long k = 0; k < g.nnz; k++) {
+            if (nb == 0 || tri[k] != tri[nb - 1]) tri[nb++] = tri[k];
+        }
+        if (nb <= 65536) {
+            g.dictionnaire = (float*)realloc(tri, (nb + 1) * sizeof(float));
+            if (!g.dictionnaire) erreurFatale("alloc dictionnaire");
+            g.taille_dictionnaire = (int)nb;
+            for (long k = 0; k < g.nnz; k++) {
+                float *f = (float*)bsearch(&m->valeurs[k], g.dictionnaire, nb, sizeof(float), comparerFloats);
+                g.probas[k] = (uint16_t)(f - g.dictionnaire);
+            }
+            g.mode = COMPACT_DICTIONNAIRE;
+            return g;
+        }
+        free(tri);
+    }
+    g.mode = COMPACT_FIXE16;
+    long deg_max = 0;
+    for (int i = 0; i < g.n; i++) {
+        if (m->debut[i + 1] - m->debut[i] > deg_max) deg_max = m->debut[i + 1] - m->debut[i];
+    }
+    t_reste *tmp = (t_reste*)malloc((deg_max + 1) * sizeof(t_reste));
+    if (!tmp) erreurFatale("alloc graphe compact");
+    for (int i = 0; i < g.n; i++) {
+        quantifierLigne(m->valeurs + m->debut[i], g.probas + m->debut[i],
+                        m->debut[i + 1] - m->debut[i], tmp, &g.erreur_max);
+    }
+    free(tmp);
+    return g;
+}
+
+/* arête d'une ligne en cours de compression */
+typedef struct {
+    uint32_t colonne;  // 0-based
+    float proba;
+} t_arete_ligne;
+
+static int comparerAretesLigne(const void *a, const void *b) {
+    const t_arete_ligne *x = (const t_arete_ligne*)a, *y = (const t_arete_ligne*)b;
+    return (x->colonne > y->colonne) - (x->colonne < y->colonne);
+}
+
+/* ensemble des probabilités distinctes (adressage ouvert sur le motif binaire) */
+#define DICO_CASES (1 << 17)
+
+/* ajoute p, renvoie le nombre de valeurs distinctes */
+static long ajouterValeur(float *cases, char *occupe, long nb, float p) {
+    uint32_t b, c;
+    memcpy(&b, &p, sizeof(b));
+    uint32_t h = (b * 2654435761u) >> 15;
+    while (occupe[h]) {
+        memcpy(&c, &cases[h], sizeof(c));
+        if (c == b) return nb;
+        h = (h + 1) & (DICO_CASES - 1);
+    }
+    occupe[h] = 1;
+    cases[h] = p;
+    return nb + 1;
+}
+
+/* compresserFichier
+ Construit la version compacte directement depuis un fichier texte ou binaire
+ (outofcore.h), sans liste d'adjacence ni CSR flottante. Un premier passage
+ compte les arêtes de chaque ligne (et collecte les valeurs du dictionnaire) ;
+ les lignes sont ensuite compressées par tranches d'environ nnz /
+ COMPACT_TRANCHES_MAX arêtes (au moins taille_bloc), un passage du fichier par
+ tranche : 1 + COMPACT_TRANCHES_MAX lectures au plus. Mémoire : le résultat,
+ une tranche (~2 octets par arête) et un bloc de lecture. Les arêtes hors intervalle sont ignorées, comme en hors mémoire.
+ Renvoie 0, ou -1 si le fichier est illisible ou mal formé (*g est alors vide).
+ */
+int compresserFichier(const char *chemin, t_mode_compact mode, long taille_bloc, t_graphe_compact *g) {
+    t_fichier_aretes fa;
+    memset(g, 0, sizeof(*g));
+    if (ouvrirFichierAretes(&fa, chemin) != 0) return -1;
+    if (taille_bloc <= 0) taille_bloc = BLOC_DEFAUT;
+    int n = fa.n;
+    g->n = n;
+    g->debut_aretes = (uint64_t*)calloc(n + 1, sizeof(uint64_t));
+    g->debut_octets = (uint64_t*)malloc((n + 1) * sizeof(uint64_t));
+    t_arete_binaire *bloc = (t_arete_binaire*)malloc(taille_bloc * sizeof(t_arete_binaire));
+    if (!g->debut_aretes || !g->debut_octets || !bloc) erreurFatale("alloc graphe compact");
+    float *cases = NULL;
+    char *occupe = NULL;
+    long nb_valeurs = 0;
+    int dico = mode == COMPACT_DICTIONNAIRE;
+    if (dico) {
+        cases = (float*)malloc(DICO_CASES * sizeof(float));
+        occupe = (char*)calloc(DICO_CASES, sizeof(char));
+        if (!cases || !occupe) erreurFatale("alloc dictionnaire");
+    }
+
+    /* passage 1 : degrés (décalés d'une case pour la somme préfixe) et valeurs distinctes */
+    long nb;
+    while ((nb = lireAretes(&fa, bloc, taille_bloc)) > 0) {
+        for (long k = 0; k < nb; k++) {
+            int d = bloc[k].depart, c = bloc[k].arrivee;
+            if (d < 1 || d > n || c < 1 || c > n) continue;
+            g->debut_aretes[d]++;
+            if (dico) {
+                nb_valeurs = ajouterValeur(cases, occupe, nb_valeurs, bloc[k].proba);
+                if (nb_valeurs > 65536) {
+                    dico = 0;  // trop de valeurs : virgule fixe 16 bits
+                    free(cases);
+                    free(occupe);
+                    cases = NULL;
+                    occupe = NULL;
+                }
+            }
+        }
+    }
+    int echec = fa.erreur || ferror(fa.f);
+    long deg_max = 0;
+    for (int i = 0; i < n; i++) {
+        if ((long)g->debut_aretes[i + 1] > deg_max) deg_max = (long)g->debut_aretes[i + 1];
+        g->debut_aretes[i + 1] += g->debut_aretes[i];
+    }
+    g->nnz = (long)g->debut_aretes[n];
+    if (dico) {
+        long nbv = 0;
+        for (long h = 0; h < DICO_CASES; h++) {
+            if (occupe[h]) cases[nbv++] = cases[h];
+        }
+        qsort(cases, nbv, sizeof(float), comparerFloats);
+        long nb_dico = 0;
+        for (long k = 0; k < nbv; k++) {
+            if (nb_dico == 0 || cases[k] != cases[nb_dico - 1]) cases[nb_dico++] = cases[k];
+        }
+        free(occupe);
+        g->dictionnaire = (float*)realloc(cases, (nb_dico + 1) * sizeof(float));
+        if (!g->dictionnaire) erreurFatale("alloc dictionnaire");
+        g->taille_dictionnaire = (int)nb_dico;
+    }
+    g->mode = dico ? COMPACT_DICTIONNAIRE : COMPACT_FIXE16;
+
+    /* tranches bornées par la mémoire du résultat, pas par le bloc de lecture :
+       au plus COMPACT_TRANCHES_MAX relectures du fichier, quelle que soit sa taille */
+    long cap_tranche = (g->nnz + COMPACT_TRANCHES_MAX - 1) / COMPACT_TRANCHES_MAX;
+    if (cap_tranche < taille_bloc) cap_tranche = taille_bloc;
+    if (cap_tranche < deg_max) cap_tranche = deg_max;
+    uint64_t cap_colonnes = (uint64_t)g->nnz + 16;
+    g->probas = (uint16_t*)malloc((g->nnz + 1) * sizeof(uint16_t));
+    g->colonnes = (uint8_t*)malloc(cap_colonnes);
+    t_arete_ligne *tranche = (t_arete_ligne*)malloc((cap_tranche + 1) * sizeof(t_arete_ligne));
+    float *valeurs = (float*)malloc((deg_max + 1) * sizeof(float));
+    t_reste *restes = (t_reste*)malloc((deg_max + 1) * sizeof(t_reste));
+    if (!g->probas || !g->colonnes || !tranche || !valeurs || !restes) erreurFatale("alloc graphe compact");
+
+    /* tranches de lignes [lo, hi) ; debut_octets sert de curseur de remplissage
+       (relatif au début de la tranche) avant de recevoir les positions finales */
+    uint64_t pos = 0;
+    int lo = 0;
+    while (!echec && lo < n) {
+        int hi = lo + 1;
+        uint64_t base = g->debut_aretes[lo];
+        while (hi < n && g->debut_aretes[hi + 1] - base <= (uint64_t)cap_tranche) hi++;
+        if (g->debut_aretes[hi] > base) {
+            for (int r = lo; r < hi; r++) g->debut_octets[r] = g->debut_aretes[r] - base;
+            rembobinerFichierAretes(&fa);
+            while (!fa.erreur && (nb = lireAretes(&fa, bloc, taille_bloc)) > 0) {
+                for (long k = 0; k < nb; k++) {
+                    int d = bloc[k].depart, c = bloc[k].arrivee;
+                    if (d <= lo || d > hi || c < 1 || c > n) continue;
+                    uint64_t q = g->debut_octets[d - 1];
+                    if (q >= g->debut_aretes[d] - base) continue;  // fichier modifié entre deux passages
+                    tranche[q].colonne = (uint32_t)(c - 1);
+                    tranche[q].proba = bloc[k].proba;
+                    g->debut_octets[d - 1] = q + 1;
+                }
+            }
+            if (fa.erreur || ferror(fa.f)) {
+                echec = 1;
+                break;
+            }
+        }
+        for (int r = lo; r < hi; r++) {
+            t_arete_ligne *a = tranche + (g->debut_aretes[r] - base);
+            long deg = (long)(g->debut_aretes[r + 1] - g->debut_aretes[r]);
+            qsort(a, deg, sizeof(t_arete_ligne), comparerAretesLigne);
+            if (pos + 5 * (uint64_t)deg > cap_colonnes) {
+                cap_colonnes = cap_colonnes + cap_colonnes / 2 + 5 * (uint64_t)deg;
+                uint8_t *c = (uint8_t*)realloc(g->colonnes, cap_colonnes);
+                if (!c) erreurFatale("alloc graphe compact");
+                g->colonnes = c;
+            }
+            g->debut_octets[r] = pos;
+            uint32_t prec = 0;
+            uint16_t *q = g->probas + g->debut_aretes[r];
+            for (long k = 0; k < deg; k++) {
+                pos += ecrireVarint(g->colonnes + pos, a[k].colonne - prec);
+                prec = a[k].colonne;
+                if (dico) {
+                    float *f = (float*)bsearch(&a[k].proba, g->dictionnaire, g->taille_dictionnaire,
+                                               sizeof(float), comparerFloats);
+                    q[k] = (uint16_t)(f - g->dictionnaire);
+                } else {
+                    valeurs[k] = a[k].proba;
+                }
+            }
+            if (!dico) quantifierLigne(valeurs, q, deg, restes, &g->erreur_max);
+        }
+        lo = hi;
+    }
+    g->debut_octets[n] = pos;
+    free(bloc);
+    free(tranche);
+    free(valeurs);
+    free(restes);
+    fermerFichierAretes(&fa);
+    if (echec) {
+        libererGrapheCompact(g);
+        return -1;
+    }
+    uint8_t *c = (uint8_t*)realloc(g->colonnes, pos + 1);
+    if (c) g->colonnes = c;
+    return 0;
+}
+
+/* stationnaireCompact
+ Itération de puissance pi <- pi * P sur le stockage compact. pi sert de point
+ de départ s'il est non nul (limite depuis cette loi), sinon loi uniforme.
+ Renvoie le nombre d'itérations.
+ */
+int stationnaireCompact(t_graphe_compact *g, float *pi, float epsilon, int max_iter) {
+    int n = g->n;
+    float masse = 0.0f;
+    for (int i = 0; i < n; i++) masse += pi[i];
+    if (masse == 0.0f) {
+        for (int i = 0; i < n; i++) pi[i] = 1.0f / n;
+    }
+    float *tmp = createZeroVector(n);
+    int iter = 0;
+    while (iter < max_iter) {
+        multiplyVectorCompact(pi, g, tmp);
+        float d = diffVectors(pi, tmp, n);
+        copyVector(pi, tmp, n);
+        iter++;
+        if (d < epsilon) break;
+    }
+    freeVector(tmp);
+    return iter;
+}
+
+/* out = vec * P en décodant le flux compact ligne par ligne */
+void multiplyVectorCompact(float *vec, t_graphe_compact *g, float *out) {
+    const float echelle = 1.0f / 65535.0f;
+    for (int j = 0; j < g->n; j++) out[j] = 0.0f;
+    for (int i = 0; i < g->n; i++) {
+        float vi = vec[i];
+        if (vi == 0.0f) continue;
+        const uint8_t *p = g->colonnes + g->debut_octets[i];
+        const uint8_t *fin = g->colonnes + g->debut_octets[i + 1];
+        const uint16_t *q = g->probas + g->debut_aretes[i];
+        uint32_t col = 0;
+        if (g->mode == COMPACT_DICTIONNAIRE) {
+            while (p < fin) {
+                uint32_t d = 0;
+                int dec = 0;
+                do { d |= (uint32_t)(*p & 0x7f) << dec; dec += 7; } while (*p++ & 0x80);
+                col += d;
+                out[col] += vi * g->dictionnaire[*q++];
+            }
+        } else {
+            float vs = vi * echelle;
+            while (p < fin) {
+                uint32_t d = 0;
+                int dec = 0;
+                do { d |= (uint32_t)(*p & 0x7f) << dec; dec += 7; } while (*p++ & 0x80);
+                col += d;
+                out[col] += vs * (float)(*q++);
+            }
+        }
+    }
+}
+
+/* nombre d'octets occupés par la représentation compacte */
+size_t tailleGrapheCompact(t_graphe_compact *g) {
+    return sizeof(*g)
+         + 2 * (size_t)(g->n + 1) * sizeof(uint64_t)
+         + (size_t)g->debut_octets[g->n]
+         + (size_t)g->nnz * sizeof(uint16_t)
+         + (size_t)g->taille_dictionnaire * sizeof(float);
+}
+
+void libererGrapheCompact(t_graphe_compact *g) {
+    if (!g) return;
+    free(g->debut_octets);
+    free(g->debut_aretes);
+    free(g->colonnes);
+    free(g->probas);
+    free(g->dictionnaire);
+    memset(g, 0, sizeof(*g));
+}
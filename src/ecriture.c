@@ -0,0 +1,274 @@
+#include "ecriture.h"
+
+/* abandon sur erreur fatale (cf. suivreRessource) : tampon libéré, fichier fermé */
+static void abandonnerEcrivain(void *p) {
+    t_ecrivain *e = (t_ecrivain*)p;
+    free(e->tampon);
+    e->tampon = NULL;
+    if (e->f != stdout && e->f != stderr) fclose(e->f);
+}
+
+/* initialise un écrivain sur un flux déjà ouvert (stdout ou fichier) ; sous un
+ point de reprise, le flux appartient à l'écrivain jusqu'à fermerEcrivain */
+void initEcrivain(t_ecrivain *e, FILE *f) {
+    e->f = f;
+    e->len = 0;
+    e->erreur = 0;
+    e->tampon = NULL;
+    suivreRessource(e, abandonnerEcrivain);
+    e->tampon = (char*)malloc(ECRITURE_TAMPON);
+    if (!e->tampon) erreurFatale("alloc tampon écriture");
+}
+
+/* envoie le contenu du tampon au flux */
+void viderEcrivain(t_ecrivain *e) {
+    if (e->len > 0 && fwrite(e->tampon, 1, e->len, e->f) != e->len) e->erreur = 1;
+    e->len = 0;
+}
+
+/* vide le tampon et le libère (le flux reste ouvert), renvoie 0 ou -1 si une écriture a échoué */
+int fermerEcrivain(t_ecrivain *e) {
+    oublierRessource(e);
+    viderEcrivain(e);
+    free(e->tampon);
+    e->tampon = NULL;
+    if (fflush(e->f) != 0) e->erreur = 1;
+    return e->erreur ? -1 : 0;
+}
+
+/* garantit au moins n octets libres (n <= ECRITURE_TAMPON) */
+static inline void reserver(t_ecrivain *e, size_t n) {
+    if (e->len + n > ECRITURE_TAMPON) viderEcrivain(e);
+}
+
+void ecrireOctets(t_ecrivain *e, const void *octets, size_t n) {
+    if (n > ECRITURE_TAMPON / 2) {
+        viderEcrivain(e);
+        if (fwrite(octets, 1, n, e->f) != n) e->erreur = 1;
+        return;
+    }
+    reserver(e, n);
+    memcpy(e->tampon + e->len, octets, n);
+    e->len += n;
+}
+
+void ecrireTexte(t_ecrivain *e, const char *s) {
+    ecrireOctets(e, s, strlen(s));
+}
+
+void ecrireCaractere(t_ecrivain *e, char c) {
+    reserver(e, 1);
+    e->tampon[e->len++] = c;
+}
+
+/* chiffres de u écrits à partir de la fin de fin[], renvoie le début */
+static char *chiffres(unsigned long long u, char *fin) {
+    do {
+        *--fin = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    return fin;
+}
+
+void ecrireEntier(t_ecrivain *e, long long v) {
+    char buf[24];
+    char *fin = buf + sizeof(buf);
+    unsigned long long u = v < 0 ? 0ULL - (unsigned long long)v : (unsigned long long)v;
+    char *p = chiffres(u, fin);
+    if (v < 0) *--p = '-';
+    ecrireOctets(e, p, (size_t)(fin - p));
+}
+
+static const double puissances10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+};
+
+/* ecrireFlottant
+ Même texte que printf("%.*f", decimales, v) : v * 10^decimales est arrondi à
+ l'entier le plus proche puis écrit en deux parties. Le produit est lui-même
+ arrondi ; quand il tombe trop près d'une demi-unité pour trancher, ainsi que
+ hors de portée (plus de 9 décimales, très grandes valeurs, nan, inf), on
+ passe par snprintf.
+ */
+void ecrireFlottant(t_ecrivain *e, double v, int decimales) {
+    if (decimales < 0) decimales = 0;
+    double echelle = puissances10[decimales > 9 ? 9 : decimales];
+    double y = fabs(v) * echelle;
+    if (decimales > 9 || !(y < 1e15) || fabs(y - floor(y) - 0.5) < 1e-6) {
+        char buf[512];
+        int n = snprintf(buf, sizeof(buf), "%.*f", decimales, v);
+        if (n > 0) ecrireOctets(e, buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+        return;
+    }
+    int negatif = signbit(v);
+    unsigned long long u = (unsigned long long)nearbyint(y);
+    unsigned long long entier = u / (unsigned long long)echelle;
+    unsigned long long frac = u % (unsigned long long)echelle;
+    char buf[40];
+    char *fin = buf + sizeof(buf);
+    char *p = fin;
+    if (decimales > 0) {
+        for (int k = 0; k < decimales; k++) {
+            *--p = (char)('0' + frac % 10);
+            frac /= 10;
+        }
+        *--p = '.';
+    }
+    p = chiffres(entier, p);
+    if (negatif) *--p = '-';
+    ecrireOctets(e, p, (size_t)(fin - p));
+}
+
+/* identifiant lisible du sommet (A, ..., Z, AA, ...), cf. getIdR */
+void ecrireIdSommet(t_ecrivain *e, int num) {
+    char buf[16];
+    char *fin = buf + sizeof(buf);
+    char *p = fin;
+    if (num <= 0) {
+        ecrireCaractere(e, '?');
+        return;
+    }
+    while (num > 0) {
+        num--;
+        *--p = (char)('A' + num % 26);
+        num /= 26;
+    }
+    ecrireOctets(e, p, (size_t)(fin - p));
+}
+
+/* ouvre fichier et prépare l'écrivain, renvoie -1 si le fichier ne peut être créé */
+static int ouvrirFichier(t_ecrivain *e, const char *fichier, const char *mode) {
+    FILE *f = fopen(fichier, mode);
+    if (!f) return -1;
+    initEcrivain(e, f);
+    return 0;
+}
+
+static int fermerFichier(t_ecrivain *e) {
+    int res = fermerEcrivain(e);
+    if (fclose(e->f) != 0) res = -1;
+    return res;
+}
+
+/* une ligne de la matrice par ligne du fichier, valeurs séparées par des virgules */
+int ecrireMatriceCSV(t_matrix m, const char *fichier) {
+    t_ecrivain e;
+    if (ouvrirFichier(&e, fichier, "wt") != 0) return -1;
+    for (int i = 0; i < m.rows; i++) {
+        for (int j = 0; j < m.cols; j++) {
+            if (j > 0) ecrireCaractere(&e, ',');
+            ecrireFlottant(&e, m.data[i][j], 8);
+        }
+        ecrireCaractere(&e, '\n');
+    }
+    return fermerFichier(&e);
+}
+
+int ecrireMatriceBinaire(t_matrix m, const char *fichier) {
+    t_ecrivain e;
+    if (ouvrirFichier(&e, fichier, "wb") != 0) return -1;
+    unsigned int magic = MATRICE_MAGIC;
+    ecrireOctets(&e, &magic, sizeof(magic));
+    ecrireOctets(&e, &m.rows, sizeof(int));
+    ecrireOctets(&e, &m.cols, sizeof(int));
+    for (int i = 0; i < m.rows; i++) {
+        ecrireOctets(&e, m.data[i], (size_t)m.cols * sizeof(float));
+    }
+    return fermerFichier(&e);
+}
+
+/* ligne i de P dans un tampon de n flottants (arêtes en double additionnées,
+ comme createMatrixFromAdjacency) */
+static void ligneDense(liste_adjacence la, int i, float *ligne) {
+    memset(ligne, 0, (size_t)la.taille * sizeof(float));
+    for (cellule *c = la.tab[i].head; c; c = c->suivant) ligne[c->arrivee - 1] += c->proba;
+}
+
+/* ecrireGrapheCSV, ecrireGrapheBinaire
+ Même fichier que ecrireMatriceCSV / ecrireMatriceBinaire appliqués à
+ createMatrixFromAdjacency(la), sans construire la matrice n x n : chaque ligne
+ est reconstituée depuis la liste d'adjacence (mémoire O(n)).
+ */
+int ecrireGrapheCSV(liste_adjacence la, const char *fichier) {
+    int n = la.taille;
+    float *ligne = (float*)malloc(((size_t)n + 1) * sizeof(float));
+    if (!ligne) erreurFatale("alloc export");
+    t_ecrivain e;
+    if (ouvrirFichier(&e, fichier, "wt") != 0) {
+        free(ligne);
+        return -1;
+    }
+    for (int i = 0; i < n; i++) {
+        ligneDense(la, i, ligne);
+        for (int j = 0; j < n; j++) {
+            if (j > 0) ecrireCaractere(&e, ',');
+            /* zéros (le cas courant) écrits directement */
+            if (ligne[j] == 0.0f && !signbit(ligne[j])) ecrireOctets(&e, "0.00000000", 10);
+            else ecrireFlottant(&e, ligne[j], 8);
+        }
+        ecrireCaractere(&e, '\n');
+    }
+    free(ligne);
+    return fermerFichier(&e);
+}
+
+int ecrireGrapheBinaire(liste_adjacence la, const char *fichier) {
+    int n = la.taille;
+    float *ligne = (float*)malloc(((size_t)n + 1) * sizeof(float));
+    if (!ligne) erreurFatale("alloc export");
+    t_ecrivain e;
+    if (ouvrirFichier(&e, fichier, "wb") != 0) {
+        free(ligne);
+        return -1;
+    }
+    unsigned int magic = MATRICE_MAGIC;
+    ecrireOctets(&e, &magic, sizeof(magic));
+    ecrireOctets(&e, &n, sizeof(int));
+    ecrireOctets(&e, &n, sizeof(int));
+    for (int i = 0; i < n; i++) {
+        ligneDense(la, i, ligne);
+        ecrireOctets(&e, ligne, (size_t)n * sizeof(float));
+    }
+    free(ligne);
+    return fermerFichier(&e);
+}
+
+/* une valeur par ligne */
+int ecrireVecteurCSV(const float *v, int n, const char *fichier) {
+    t_ecrivain e;
+    if (ouvrirFichier(&e, fichier, "wt") != 0) return -1;
+    for (int i = 0; i < n; i++) {
+        ecrireFlottant(&e, v[i], 8);
+        ecrireCaractere(&e, '\n');
+    }
+    return fermerFichier(&e);
+}
+
+int ecrireVecteurBinaire(const float *v, int n, const char *fichier) {
+    t_ecrivain e;
+    if (ouvrirFichier(&e, fichier, "wb") != 0) return -1;
+    unsigned int magic = VECTEUR_MAGIC;
+    ecrireOctets(&e, &magic, sizeof(magic));
+    ecrireOctets(&e, &n, sizeof(int));
+    ecrireOctets(&e, v, (size_t)n * sizeof(float));
+    return fermerFichier(&e);
+}
+
+/* graphe au format d'entrée habituel (n, puis "depart arrivee proba"), 9 décimales */
+int ecrireGrapheTexte(liste_adjacence la, const char *fichier) {
+    t_ecrivain e;
+    if (ouvrirFichier(&e, fichier, "wt") != 0) return -1;
+    ecrireEntier(&e, la.taille);
+    ecrireCaractere(&e, '\n');
+    for (int i = 0; i < la.taille; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) {
+            ecrireEntier(&e, i + 1);
+            ecrireCaractere(&e, ' ');
+            ecrireEntier(&e, c->arrivee);
+            ecrireCaractere(&e, ' ');
+            ecrireFlottant(&e, c->proba, 9);
+            ecrireCaractere(&e, '\n');
+        }
+    }
+    return fermerFichier(&e);
+}
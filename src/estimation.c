@@ -0,0 +1,300 @@
+#define _FILE_OFFSET_BITS 64
+#include "estimation.h"
+#include "ordonnanceur.h"
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#define fseek64 _fseeki64
+#define ftell64 _ftelli64
+#else
+#define fseek64 fseeko
+#define ftell64 ftello
+#endif
+
+#define TAILLE_LECTURE (1 << 20)
+
+/* table de comptage à adressage ouvert, clé = (départ << 32) | arrivée, jamais nulle */
+typedef struct {
+    uint64_t *cles;
+    unsigned long long *nb;
+    size_t cap;        // puissance de 2
+    size_t taille;
+} t_table;
+
+static void initTable(t_table *t, size_t cap) {
+    t->cap = cap;
+    t->taille = 0;
+    t->cles = (uint64_t*)calloc(cap, sizeof(uint64_t));
+    t->nb = (unsigned long long*)calloc(cap, sizeof(unsigned long long));
+    if (!t->cles || !t->nb) erreurFatale("alloc table estimation");
+}
+
+/* les deux moitiés du produit sont repliées : sans cela, pour une petite
+   table, le sommet de départ (bits 32 à 63 de la clé) serait ignoré */
+static size_t hacher(uint64_t cle, size_t cap) {
+    uint64_t h = cle * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(h ^ (h >> 32)) & (cap - 1);
+}
+
+static void ajouterTable(t_table *t, uint64_t cle, unsigned long long nb);
+
+static void agrandirTable(t_table *t) {
+    t_table n;
+    initTable(&n, t->cap * 2);
+    for (size_t i = 0; i < t->cap; i++) {
+        if (t->cles[i]) ajouterTable(&n, t->cles[i], t->nb[i]);
+    }
+    free(t->cles);
+    free(t->nb);
+    *t = n;
+}
+
+static void ajouterTable(t_table *t, uint64_t cle, unsigned long long nb) {
+    if (2 * (t->taille + 1) > t->cap) agrandirTable(t);
+    size_t i = hacher(cle, t->cap);
+    while (t->cles[i] && t->cles[i] != cle) i = (i + 1) & (t->cap - 1);
+    if (!t->cles[i]) {
+        t->cles[i] = cle;
+        t->taille++;
+    }
+    t->nb[i] += nb;
+}
+
+/* tranche [debut, fin) du fichier traitée par un thread */
+typedef struct {
+    const char *fichier;
+    long long debut, fin;
+    t_table table;
+    int max_etat;
+    unsigned long long total;
+    long long lignes_invalides;
+    int erreur;
+} t_tranche_log;
+
+static void *compterTranche(void *arg) {
+    t_tranche_log *tr = (t_tranche_log*)arg;
+    initTable(&tr->table, 1 << 12);
+    FILE *f = fopen(tr->fichier, "rb");
+    char *buf = (char*)malloc(TAILLE_LECTURE);
+    if (!f || !buf || fseek64(f, tr->debut, SEEK_SET) != 0) {
+        tr->erreur = 1;
+        if (f) fclose(f);
+        free(buf);
+        return NULL;
+    }
+    long long reste = tr->fin - tr->debut;
+    uint64_t precedent = 0;   // 0 : début de séquence
+    uint64_t valeur = 0;
+    int dans_nombre = 0;
+    int ignorer = 0;          // reste de la ligne ignoré (commentaire ou ligne invalide)
+    int debut_ligne = 1;
+    while (reste > 0) {
+        size_t a_lire = reste < TAILLE_LECTURE ? (size_t)reste : TAILLE_LECTURE;
+        size_t lu = fread(buf, 1, a_lire, f);
+        if (lu == 0) break;
+        reste -= lu;
+        for (size_t k = 0; k < lu; k++) {
+            char c = buf[k];
+            if (c >= '0' && c <= '9') {
+                if (!ignorer) {
+                    valeur = valeur * 10 + (uint64_t)(c - '0');
+                    dans_nombre = 1;
+                    if (valeur > INT_MAX) {
+                        tr->lignes_invalides++;
+                        ignorer = 1;
+                        dans_nombre = 0;
+                    }
+                }
+                debut_ligne = 0;
+                continue;
+            }
+            /* fin d'un nombre : c'est un état de la séquence */
+            if (dans_nombre) {
+                if (valeur == 0) {
+                    tr->lignes_invalides++;
+                    ignorer = 1;
+                } else {
+                    if (precedent) {
+                        ajouterTable(&tr->table, (precedent << 32) | valeur, 1);
+                        tr->total++;
+                    }
+                    precedent = valeur;
+                    if ((int)valeur > tr->max_etat) tr->max_etat = (int)valeur;
+                }
+                dans_nombre = 0;
+                valeur = 0;
+            }
+            if (c == '\n') {
+                precedent = 0;
+                ignorer = 0;
+                debut_ligne = 1;
+            } else if (c == ' ' || c == '\t' || c == ',' || c == ';' || c == '\r') {
+                continue;
+            } else if (!ignorer) {
+                if (!(c == '#' && debut_ligne)) tr->lignes_invalides++;
+                ignorer = 1;
+            }
+        }
+    }
+    /* dernière ligne sans '\n' final */
+    if (dans_nombre && !ignorer && valeur > 0) {
+        if (precedent) {
+            ajouterTable(&tr->table, (precedent << 32) | valeur, 1);
+            tr->total++;
+        }
+        if ((int)valeur > tr->max_etat) tr->max_etat = (int)valeur;
+    }
+    fclose(f);
+    free(buf);
+    return NULL;
+}
+
+/* position du premier octet après le prochain '\n' à partir de 'pos' (ou taille) */
+static long long debutLigneSuivante(FILE *f, long long pos, long long taille) {
+    if (pos <= 0) return 0;
+    if (fseek64(f, pos - 1, SEEK_SET) != 0) return taille;
+    pos--;
+    int c;
+    while ((c = fgetc(f)) != EOF) {
+        pos++;
+        if (c == '\n') return pos;
+    }
+    return taille;
+}
+
+static int comparerComptages(const void *a, const void *b) {
+    const t_comptage *x = (const t_comptage*)a;
+    const t_comptage *y = (const t_comptage*)b;
+    if (x->depart != y->depart) return x->depart < y->depart ? -1 : 1;
+    return (x->arrivee > y->arrivee) - (x->arrivee < y->arrivee);
+}
+
+/* estimerTransitions
+ Compte les transitions du journal avec nb_threads threads (<= 0 : un par cœur).
+ Renvoie 0, ou -1 si le fichier est illisible.
+ */
+int estimerTransitions(const char *fichier, int nb_threads, t_estimation *out) {
+    if (nb_threads <= 0) nb_threads = nombreCoeurs();
+    FILE *f = fopen(fichier, "rb");
+    if (!f) return -1;
+    if (fseek64(f, 0, SEEK_END) != 0) {
+        fclose(f);
+        return -1;
+    }
+    long long taille = ftell64(f);
+    if (taille < (long long)nb_threads * TAILLE_LECTURE) {
+        nb_threads = (int)(taille / TAILLE_LECTURE) + 1;
+    }
+
+    /* tranches alignées sur les débuts de ligne : aucune séquence n'est coupée */
+    t_tranche_log *tr = (t_tranche_log*)calloc(nb_threads, sizeof(t_tranche_log));
+    pthread_t *threads = (pthread_t*)malloc(nb_threads * sizeof(pthread_t));
+    char *lance = (char*)calloc(nb_threads, sizeof(char));
+    if (!tr || !threads || !lance) erreurFatale("alloc estimation");
+    long long debut = 0;
+    for (int k = 0; k < nb_threads; k++) {
+        long long fin = k == nb_threads - 1 ? taille
+                        : debutLigneSuivante(f, taille / nb_threads * (k + 1), taille);
+        if (fin < debut) fin = debut;
+        tr[k].fichier = fichier;
+        tr[k].debut = debut;
+        tr[k].fin = fin;
+        debut = fin;
+    }
+    fclose(f);
+    /* la tranche 0 est traitée par le thread appelant (ou toute tranche dont le thread n'a pu être créé) */
+    for (int k = 1; k < nb_threads; k++) {
+        lance[k] = pthread_create(&threads[k], NULL, compterTranche, &tr[k]) == 0;
+    }
+    for (int k = 0; k < nb_threads; k++) {
+        if (!lance[k]) compterTranche(&tr[k]);
+    }
+    int erreur = 0;
+    for (int k = 0; k < nb_threads; k++) {
+        if (lance[k]) pthread_join(threads[k], NULL);
+        if (tr[k].erreur) erreur = 1;
+    }
+
+    /* fusion : les tables des threads sont versées dans la première */
+    out->nb_etats = 0;
+    out->total = 0;
+    out->lignes_invalides = 0;
+    for (int k = 0; k < nb_threads; k++) {
+        if (tr[k].max_etat > out->nb_etats) out->nb_etats = tr[k].max_etat;
+        out->total += tr[k].total;
+        out->lignes_invalides += tr[k].lignes_invalides;
+        if (k == 0) continue;
+        for (size_t i = 0; i < tr[k].table.cap; i++) {
+            if (tr[k].table.cles[i]) ajouterTable(&tr[0].table, tr[k].table.cles[i], tr[k].table.nb[i]);
+        }
+        free(tr[k].table.cles);
+        free(tr[k].table.nb);
+    }
+    t_table *t = &tr[0].table;
+    out->nb_comptages = (long)t->taille;
+    out->comptages = (t_comptage*)malloc((t->taille + 1) * sizeof(t_comptage));
+    if (!out->comptages) erreurFatale("alloc estimation");
+    long n = 0;
+    for (size_t i = 0; i < t->cap; i++) {
+        if (!t->cles[i]) continue;
+        out->comptages[n].depart = (int)(t->cles[i] >> 32);
+        out->comptages[n].arrivee = (int)(t->cles[i] & 0xFFFFFFFFu);
+        out->comptages[n].nb = t->nb[i];
+        n++;
+    }
+    free(t->cles);
+    free(t->nb);
+    qsort(out->comptages, n, sizeof(t_comptage), comparerComptages);
+    free(tr);
+    free(threads);
+    free(lance);
+    if (erreur) {
+        libererEstimation(out);
+        return -1;
+    }
+    return 0;
+}
+
+/* total sortant de chaque état (indices 1..nb_etats) */
+static unsigned long long *totauxSortants(t_estimation *e) {
+    unsigned long long *tot = (unsigned long long*)calloc(e->nb_etats + 1, sizeof(unsigned long long));
+    if (!tot) erreurFatale("alloc estimation");
+    for (long k = 0; k < e->nb_comptages; k++) tot[e->comptages[k].depart] += e->comptages[k].nb;
+    return tot;
+}
+
+/* graphe estimé en mémoire (un état sans transition sortante n'a pas d'arête) */
+liste_adjacence grapheEstime(t_estimation *e) {
+    liste_adjacence la = creerListeAdjacence(e->nb_etats);
+    unsigned long long *tot = totauxSortants(e);
+    /* parcours à rebours : l'insertion en tête laisse chaque liste triée */
+    for (long k = e->nb_comptages - 1; k >= 0; k--) {
+        t_comptage *c = &e->comptages[k];
+        ajouterCellule(&la.tab[c->depart - 1], c->arrivee, (float)((double)c->nb / tot[c->depart]));
+    }
+    free(tot);
+    return la;
+}
+
+/* écrit le graphe estimé au format lu par readGraph ; renvoie 0 ou -1 */
+int ecrireGrapheEstime(t_estimation *e, const char *fichier) {
+    FILE *f = fopen(fichier, "w");
+    if (!f) return -1;
+    unsigned long long *tot = totauxSortants(e);
+    fprintf(f, "%d\n", e->nb_etats);
+    for (long k = 0; k < e->nb_comptages; k++) {
+        t_comptage *c = &e->comptages[k];
+        fprintf(f, "%d %d %.8g\n", c->depart, c->arrivee, (double)c->nb / tot[c->depart]);
+    }
+    free(tot);
+    return fclose(f) == 0 ? 0 : -1;
+}
+
+void libererEstimation(t_estimation *e) {
+    if (!e) return;
+    free(e->comptages);
+    e->comptages = NULL;
+    e->nb_comptages = 0;
+}
@@ -1,11 +1,11 @@
 #include "graph.h"
+#include "ingest.h"
 
 /* crée et initialise une cellule représentant une arête */
 cellule* creerCellule(int arrivee, float proba) {
     cellule* newCell = (cellule*)malloc(sizeof(cellule));
     if (!newCell) {
-        perror("Erreur d'allocation mémoire pour cellule");
-        exit(EXIT_FAILURE);
+        erreurFatale("Erreur d'allocation mémoire pour cellule");
     }
     newCell->arrivee = arrivee;
     newCell->proba = proba;
@@ -27,6 +27,31 @@ void ajouterCellule(liste* l, int arrivee, float proba) {
     l->head = newCell;
 }
 
+/* renvoie la cellule allant vers 'arrivee' (ou NULL si absente) */
+cellule* trouverCellule(liste l, int arrivee) {
+    cellule* tmp = l.head;
+    while (tmp) {
+        if (tmp->arrivee == arrivee) return tmp;
+        tmp = tmp->suivant;
+    }
+    return NULL;
+}
+
+/* retire l'arête vers 'arrivee' de la liste, renvoie 1 si supprimée, 0 sinon */
+int supprimerCellule(liste* l, int arrivee) {
+    cellule** pp = &l->head;
+    while (*pp) {
+        if ((*pp)->arrivee == arrivee) {
+            cellule* old = *pp;
+            *pp = old->suivant;
+            free(old);
+            return 1;
+        }
+        pp = &(*pp)->suivant;
+    }
+    return 0;
+}
+
 /*affiche les arêtes d'une liste */
 void afficherListe(liste l) {
     cellule* tmp = l.head;
@@ -43,8 +68,7 @@ liste_adjacence creerListeAdjacence(int taille) {
     la.taille = taille;
     la.tab = (liste*)malloc(taille * sizeof(liste));
     if (!la.tab) {
-        perror("Erreur d'allocation mémoire pour la liste d'adjacence");
-        exit(EXIT_FAILURE);
+        erreurFatale("Erreur d'allocation mémoire pour la liste d'adjacence");
     }
     for (int i = 0; i < taille; i++) {
         la.tab[i] = creerListe();
@@ -60,29 +84,41 @@ void afficherListeAdjacence(liste_adjacence la) {
     }
 }
 
-/* lit un graphe pondéré depuis un fichier et retourne la liste d'adjacence */
+/* chargerGraphe
+ Lit un graphe pondéré depuis un fichier sans jamais quitter le programme :
+ renvoie GRAPHE_OK, GRAPHE_ERR_FICHIER ou GRAPHE_ERR_FORMAT. La lecture passe
+ par ingererGraphe (sans renormalisation ni tri) : les doublons sont fusionnés, les
+ arêtes de probabilité nulle retirées, et les lignes rejetées (mal formées,
+ sommet hors intervalle, probabilité invalide) sont comptées dans *nb_ignorees
+ (si non NULL).
+ */
+int chargerGraphe(const char* filename, liste_adjacence* out, int* nb_ignorees) {
+    t_options_ingest opt;
+    optionsIngestParDefaut(&opt);
+    opt.trier = 0;   // même ordre des arêtes que l'ancienne lecture par ajouterCellule
+    t_rapport_ingest r;
+    int res = ingererGraphe(filename, &opt, out, &r);
+    if (nb_ignorees) *nb_ignorees = (int)(r.lignes_invalides + r.hors_intervalle + r.probas_invalides);
+    return res;
+}
+
+/* lit un graphe pondéré depuis un fichier et retourne la liste d'adjacence (quitte en cas d'erreur) */
 liste_adjacence readGraph(const char* filename) {
-    FILE* file = fopen(filename, "rt");
-    if (!file) {
+    liste_adjacence la;
+    int nb_ignorees = 0;
+    int res = chargerGraphe(filename, &la, &nb_ignorees);
+    if (res == GRAPHE_ERR_FICHIER) {
         perror("Impossible d'ouvrir le fichier");
         exit(EXIT_FAILURE);
     }
-    int nbvert, depart, arrivee;
-    float proba;
-    if (fscanf(file, "%d", &nbvert) != 1) {
-        perror("Erreur lors de la lecture du nombre de sommets");
-        fclose(file);
+    if (res == GRAPHE_ERR_FORMAT) {
+        fprintf(stderr, "Erreur lors de la lecture du nombre de sommets\n");
         exit(EXIT_FAILURE);
     }
-    liste_adjacence la = creerListeAdjacence(nbvert);
-    while (fscanf(file, "%d %d %f", &depart, &arrivee, &proba) == 3) {
-        if (depart >= 1 && depart <= nbvert) {
-            ajouterCellule(&la.tab[depart - 1], arrivee, proba);
-        } else {
-            fprintf(stderr, "Avertissement: sommet de depart %d hors intervalle\n", depart);
-        }
+    if (nb_ignorees > 0) {
+        fprintf(stderr, "Avertissement: %d ligne(s) ignorée(s) (mal formée, sommet hors intervalle ou probabilité invalide)\n",
+                nb_ignorees);
     }
-    fclose(file);
     return la;
 }
 
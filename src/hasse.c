@@ -1,44 +1,125 @@
 #include <malloc.h>
 #include "graph.h"
 
-/* removeTransitiveLinks: supprime les liens transitifs du t_link_array */
+/* removeTransitiveLinks: supprime les liens transitifs du t_link_array
+ Un lien a -> c est transitif si c est atteignable depuis un autre successeur
+ de a. Les successeurs de chaque classe sont parcourus dans l'ordre
+ topologique : un successeur déjà marqué par le parcours d'un successeur
+ précédent est transitif, sinon on marque ses descendants. Coût
+ O(C * (C + L)) au lieu de O(L^3). Un lien supprimé est remplacé par le
+ dernier lien, comme auparavant (même ordre des liens conservés).
+ */
 void removeTransitiveLinks(t_link_array *p_link_array)
 {
-    int i = 0;
-    while (i < p_link_array->size)
+    int nb_liens = p_link_array->size;
+    t_link *links = p_link_array->links;
+    if (nb_liens == 0) return;
+    int nb = 0;
+    for (int k = 0; k < nb_liens; k++)
+    {
+        if (links[k].from > nb) nb = links[k].from;
+        if (links[k].to > nb) nb = links[k].to;
+    }
+    int *debut = (int*)calloc(nb + 2, sizeof(int));      // liens par départ
+    int *entrants = (int*)calloc(nb + 2, sizeof(int));   // liens par arrivée
+    int *sortants = (int*)malloc(nb_liens * sizeof(int));
+    int *par_arrivee = (int*)malloc(nb_liens * sizeof(int));
+    int *succ = (int*)malloc(nb_liens * sizeof(int));     // par départ, arrivées en ordre topologique
+    int *fin_succ = (int*)malloc((nb + 2) * sizeof(int));
+    int *ordre = (int*)malloc((nb + 1) * sizeof(int));
+    int *degre = (int*)calloc(nb + 1, sizeof(int));
+    int *marque = (int*)calloc(nb + 1, sizeof(int));
+    int *pile = (int*)malloc((nb + 1) * sizeof(int));
+    char *transitif = (char*)calloc(nb_liens, sizeof(char));
+    int *id = (int*)malloc(nb_liens * sizeof(int));
+    if (!debut || !entrants || !sortants || !par_arrivee || !succ || !fin_succ || !ordre ||
+        !degre || !marque || !pile || !transitif || !id)
+    {
+        free(debut); free(entrants); free(sortants); free(par_arrivee); free(succ); free(fin_succ);
+        free(ordre); free(degre); free(marque); free(pile); free(transitif); free(id);
+        erreurFatale("alloc removeTransitiveLinks");
+    }
+
+    for (int k = 0; k < nb_liens; k++)
+    {
+        debut[links[k].from + 1]++;
+        entrants[links[k].to + 1]++;
+        degre[links[k].to]++;
+    }
+    for (int c = 1; c <= nb + 1; c++)
+    {
+        debut[c] += debut[c - 1];
+        entrants[c] += entrants[c - 1];
+    }
+    memcpy(fin_succ, debut, (nb + 2) * sizeof(int));
+    for (int k = 0; k < nb_liens; k++) sortants[fin_succ[links[k].from]++] = k;
+    memcpy(fin_succ, entrants, (nb + 2) * sizeof(int));
+    for (int k = 0; k < nb_liens; k++) par_arrivee[fin_succ[links[k].to]++] = k;
+
+    /* ordre topologique (Kahn) */
+    int fin = 0;
+    for (int c = 1; c <= nb; c++)
     {
-        t_link link1 = p_link_array->links[i];
-        int j = 0;
-        int to_remove = 0;
-        while (j < p_link_array->size && !to_remove)
+        if (degre[c] == 0) ordre[fin++] = c;
+    }
+    for (int t = 0; t < fin; t++)
+    {
+        int u = ordre[t];
+        for (int k = debut[u]; k < debut[u + 1]; k++)
         {
-            if (j != i)
+            int v = links[sortants[k]].to;
+            if (--degre[v] == 0) ordre[fin++] = v;
+        }
+    }
+
+    /* successeurs rangés dans l'ordre topologique de leur arrivée */
+    memcpy(fin_succ, debut, (nb + 2) * sizeof(int));
+    for (int t = 0; t < fin; t++)
+    {
+        int v = ordre[t];
+        for (int k = entrants[v]; k < entrants[v + 1]; k++)
+        {
+            int l = par_arrivee[k];
+            succ[fin_succ[links[l].from]++] = l;
+        }
+    }
+
+    /* marque[w] == u : w descend d'un successeur de u déjà traité */
+    for (int u = 1; u <= nb; u++)
+    {
+        for (int k = debut[u]; k < fin_succ[u]; k++)
+        {
+            int l = succ[k];
+            if (marque[links[l].to] == u)
             {
-                t_link link2 = p_link_array->links[j];
-                if (link1.from == link2.from)
+                transitif[l] = 1;
+                continue;
+            }
+            int sommet = 0;
+            pile[sommet++] = links[l].to;
+            while (sommet > 0)
+            {
+                int x = pile[--sommet];
+                for (int q = debut[x]; q < fin_succ[x]; q++)
                 {
-                    // rechercher un lien de link2.to vers link1.to
-                    int k = 0;
-                    while (k < p_link_array->size && !to_remove)
-                    {
-                        if (k != j && k != i)
-                        {
-                            t_link link3 = p_link_array->links[k];
-                            if ((link3.from == link2.to) && (link3.to == link1.to))
-                            {
-                                to_remove = 1;
-                            }
-                        }
-                        k++;
-                    }
+                    int w = links[succ[q]].to;
+                    if (marque[w] == u) continue;
+                    marque[w] = u;
+                    pile[sommet++] = w;
                 }
             }
-            j++;
         }
-        if (to_remove)
+    }
+
+    /* suppression en place : le lien supprimé est remplacé par le dernier */
+    for (int k = 0; k < nb_liens; k++) id[k] = k;
+    int i = 0;
+    while (i < p_link_array->size)
+    {
+        if (transitif[id[i]])
         {
-            // supprimer link1 en le remplaçant par le dernier lien
-            p_link_array->links[i] = p_link_array->links[p_link_array->size - 1];
+            links[i] = links[p_link_array->size - 1];
+            id[i] = id[p_link_array->size - 1];
             p_link_array->size--;
         }
         else
@@ -46,4 +127,6 @@ void removeTransitiveLinks(t_link_array *p_link_array)
             i++;
         }
     }
-}
\ No newline at end of file
+    free(debut); free(entrants); free(sortants); free(par_arrivee); free(succ); free(fin_succ);
+    free(ordre); free(degre); free(marque); free(pile); free(transitif); free(id);
+}
@@ -0,0 +1,290 @@
+#include "incremental.h"
+#include "hasse.h"
+#include "matrix.h"
+
+/* recalcule le diagramme de Hasse à partir des liens bruts */
+static void reconstruireHasse(t_analyse *a) {
+    free_link_array(&a->hasse);
+    init_link_array(&a->hasse);
+    for (int i = 0; i < a->liens.size; i++) {
+        add_link_if_not_exists(&a->hasse, a->liens.links[i].from, a->liens.links[i].to);
+    }
+    removeTransitiveLinks(&a->hasse);
+}
+
+/* (re)construit partition, table sommet->classe et liens depuis le graphe */
+static void analyseStructure(t_analyse *a) {
+    a->partition = tarjan(a->la);
+    a->vertex_to_class = build_vertex_to_class_map(&a->partition, a->la.taille);
+    a->liens = create_links_from_partition(a->la, &a->partition, a->vertex_to_class);
+    init_link_array(&a->hasse);
+    reconstruireHasse(a);
+}
+
+static void libererStructure(t_analyse *a) {
+    free(a->vertex_to_class);
+    a->vertex_to_class = NULL;
+    free_link_array(&a->liens);
+    free_link_array(&a->hasse);
+    free_partition(&a->partition);
+}
+
+/* renvoie 1 si la classe 'to' est atteignable depuis 'from' dans le graphe des classes.
+   Les successeurs de chaque classe sont d'abord rangés (index type CSR) : O(C + L)
+   au lieu d'un parcours de tous les liens à chaque classe dépilée. */
+static int classeAtteignable(t_link_array *liens, int nb_classes, int from, int to) {
+    if (from == to) return 1;
+    int *debut = (int*)calloc(nb_classes + 2, sizeof(int));
+    int *succ = (int*)malloc((liens->size + 1) * sizeof(int));
+    int *vu = (int*)calloc(nb_classes + 1, sizeof(int));
+    if (!debut || !succ || !vu) { erreurFatale("alloc classeAtteignable"); }
+    for (int k = 0; k < liens->size; k++) debut[liens->links[k].from + 1]++;
+    for (int c = 1; c <= nb_classes; c++) debut[c + 1] += debut[c];
+    for (int k = 0; k < liens->size; k++) succ[debut[liens->links[k].from]++] = liens->links[k].to;
+    /* debut[c] pointe maintenant sur la fin des successeurs de c, donc sur le début de c+1 */
+    for (int c = nb_classes; c >= 1; c--) debut[c] = debut[c - 1];
+    debut[0] = 0;
+    int_stack s;
+    init_stack(&s);
+    push_stack(&s, from);
+    vu[from] = 1;
+    int trouve = 0;
+    while (!stack_empty(&s) && !trouve) {
+        int c = pop_stack(&s);
+        for (int k = debut[c]; k < debut[c + 1]; k++) {
+            int d = succ[k];
+            if (d == to) { trouve = 1; break; }
+            if (!vu[d]) { vu[d] = 1; push_stack(&s, d); }
+        }
+    }
+    free_stack(&s);
+    free(vu);
+    free(succ);
+    free(debut);
+    return trouve;
+}
+
+/* renvoie 1 si 'cible' est atteignable depuis 'source' sans quitter la classe c */
+static int sommetAtteignableDansClasse(t_analyse *a, int source, int cible, int c) {
+    if (source == cible) return 1;
+    int *vu = (int*)calloc(a->la.taille + 1, sizeof(int));
+    if (!vu) { erreurFatale("alloc sommetAtteignableDansClasse"); }
+    int_stack s;
+    init_stack(&s);
+    push_stack(&s, source);
+    vu[source] = 1;
+    int trouve = 0;
+    while (!stack_empty(&s) && !trouve) {
+        int v = pop_stack(&s);
+        cellule *cur = a->la.tab[v - 1].head;
+        while (cur) {
+            int w = cur->arrivee;
+            if (w == cible) { trouve = 1; break; }
+            if (!vu[w] && a->vertex_to_class[w] == c) {
+                vu[w] = 1;
+                push_stack(&s, w);
+            }
+            cur = cur->suivant;
+        }
+    }
+    free_stack(&s);
+    free(vu);
+    return trouve;
+}
+
+/* renvoie 1 s'il reste au moins une arête de la classe cf vers la classe ct */
+static int resteArcEntreClasses(t_analyse *a, int cf, int ct) {
+    t_classe *c = &a->partition.classes[cf - 1];
+    for (int i = 0; i < c->size; i++) {
+        cellule *cur = a->la.tab[c->members[i] - 1].head;
+        while (cur) {
+            if (a->vertex_to_class[cur->arrivee] == ct) return 1;
+            cur = cur->suivant;
+        }
+    }
+    return 0;
+}
+
+/* ajout d'arête : seule la création d'un cycle entre classes force un recalcul */
+static int deltaAjout(t_analyse *a, int u, int v, float proba) {
+    cellule *cell = trouverCellule(a->la.tab[u - 1], v);
+    if (cell) {
+        cell->proba = proba;
+        return DELTA_LOCAL;
+    }
+    ajouterCellule(&a->la.tab[u - 1], v, proba);
+    int cu = a->vertex_to_class[u];
+    int cv = a->vertex_to_class[v];
+    if (cu == cv || link_exists(&a->liens, cu, cv)) return DELTA_LOCAL;
+    if (classeAtteignable(&a->liens, a->partition.nb, cv, cu)) {
+        /* cycle cu -> cv -> ... -> cu : des classes fusionnent */
+        libererStructure(a);
+        analyseStructure(a);
+        return DELTA_RECALCUL;
+    }
+    add_link_if_not_exists(&a->liens, cu, cv);
+    reconstruireHasse(a);
+    return DELTA_LOCAL;
+}
+
+/* suppression d'arête : une classe peut se scinder si u n'atteint plus v */
+static int deltaSuppression(t_analyse *a, int u, int v) {
+    if (!supprimerCellule(&a->la.tab[u - 1], v)) return DELTA_INVALIDE;
+    int cu = a->vertex_to_class[u];
+    int cv = a->vertex_to_class[v];
+    if (cu != cv) {
+        if (!resteArcEntreClasses(a, cu, cv)) {
+            remove_link(&a->liens, cu, cv);
+            reconstruireHasse(a);
+        }
+        return DELTA_LOCAL;
+    }
+    /* la classe reste fortement connexe ssi u atteint encore v à l'intérieur */
+    if (sommetAtteignableDansClasse(a, u, v, cu)) return DELTA_LOCAL;
+    libererStructure(a);
+    analyseStructure(a);
+    return DELTA_RECALCUL;
+}
+
+/* resoudreStationnaire
+ Itération de puissance à chaud depuis a->stationnaire, renormalisée (L1) à
+ chaque pas : après un DELTA_AJOUT ou DELTA_POIDS les sommes de lignes ne
+ valent plus forcément 1, et sans renormalisation la masse dériverait (ou
+ fuirait) et la convergence serait déclarée sur un vecteur de masse != 1.
+ Si toute la masse disparaît (aucune arête sortante sur le support), le
+ dernier vecteur non nul est conservé.
+ */
+static int resoudreStationnaire(t_analyse *a) {
+    int n = a->la.taille;
+    float *p = a->stationnaire;
+    float masse = 0.0f;
+    for (int i = 0; i < n; i++) masse += p[i];
+    for (int i = 0; i < n; i++) p[i] = masse > 0.0f ? p[i] / masse : 1.0f / n;
+    float *tmp = createZeroVector(n);
+    int iter = 0;
+    while (iter < a->max_iter) {
+        multiplyVectorAdjacency(p, a->la, tmp);
+        masse = 0.0f;
+        for (int i = 0; i < n; i++) masse += tmp[i];
+        if (masse <= 0.0f) break;
+        for (int i = 0; i < n; i++) tmp[i] /= masse;
+        float d = diffVectors(p, tmp, n);
+        copyVector(p, tmp, n);
+        iter++;
+        if (d < a->epsilon) break;
+    }
+    freeVector(tmp);
+    return iter;
+}
+
+/* effectue une analyse complète et conserve tous les résultats */
+t_analyse creerAnalyse(liste_adjacence la, float epsilon, int max_iter) {
+    t_analyse a;
+    a.la = la;
+    a.epsilon = epsilon;
+    a.max_iter = max_iter;
+    analyseStructure(&a);
+    int n = la.taille;
+    a.stationnaire = createZeroVector(n);
+    for (int i = 0; i < n; i++) {
+        a.stationnaire[i] = 1.0f / n;
+    }
+    a.iterations = resoudreStationnaire(&a);
+    return a;
+}
+
+/* applique une modification sans la résolution stationnaire */
+static int appliquerDeltaStructure(t_analyse *a, t_delta d) {
+    int n = a->la.taille;
+    if (d.depart < 1 || d.depart > n || d.arrivee < 1 || d.arrivee > n) {
+        return DELTA_INVALIDE;
+    }
+    switch (d.type) {
+    case DELTA_AJOUT:
+        if (d.proba <= 0.0f) return deltaSuppression(a, d.depart, d.arrivee);
+        return deltaAjout(a, d.depart, d.arrivee, d.proba);
+    case DELTA_POIDS: {
+        cellule *cell = trouverCellule(a->la.tab[d.depart - 1], d.arrivee);
+        if (!cell) return DELTA_INVALIDE;
+        if (d.proba <= 0.0f) return deltaSuppression(a, d.depart, d.arrivee);
+        cell->proba = d.proba;
+        return DELTA_LOCAL;
+    }
+    case DELTA_SUPPRESSION:
+        return deltaSuppression(a, d.depart, d.arrivee);
+    }
+    return DELTA_INVALIDE;
+}
+
+/* appliquerDelta
+ Applique une modification d'arête puis met à jour l'analyse :
+ - si la structure des classes est inchangée, seuls les liens entre classes
+   concernés sont mis à jour (sans relancer Tarjan) ;
+ - sinon, partition et liens sont recalculés.
+ Dans les deux cas la distribution stationnaire est recalculée en partant
+ de l'ancienne (démarrage à chaud, renormalisée à chaque pas), ce qui
+ converge en peu d'itérations.
+ */
+int appliquerDelta(t_analyse *a, t_delta d) {
+    int res = appliquerDeltaStructure(a, d);
+    if (res == DELTA_INVALIDE) return res;
+    a->iterations = resoudreStationnaire(a);
+    return res;
+}
+
+/* applique une série de deltas avec une seule résolution stationnaire à la fin.
+ Renvoie DELTA_RECALCUL si au moins un delta a modifié les classes. */
+int appliquerDeltas(t_analyse *a, const t_delta *deltas, int nb) {
+    int res = DELTA_LOCAL;
+    for (int i = 0; i < nb; i++) {
+        int r = appliquerDeltaStructure(a, deltas[i]);
+        if (r == DELTA_RECALCUL) res = DELTA_RECALCUL;
+    }
+    a->iterations = resoudreStationnaire(a);
+    return res;
+}
+
+/* libère toutes les structures de l'analyse (y compris le graphe) */
+void libererAnalyse(t_analyse *a) {
+    if (!a) return;
+    libererStructure(a);
+    freeVector(a->stationnaire);
+    a->stationnaire = NULL;
+    free_liste_adjacence(&a->la);
+}
+
+/* lireDeltas
+ Renvoie 0, -1 si le fichier est illisible ; les lignes mal formées sont
+ ignorées et comptées dans *invalides. *deltas est à libérer par l'appelant.
+ */
+int lireDeltas(const char *fichier, t_delta **deltas, int *nb, int *invalides) {
+    FILE *f = fopen(fichier, "r");
+    if (!f) return -1;
+    int cap = 64;
+    t_delta *d = (t_delta*)malloc(cap * sizeof(t_delta));
+    if (!d) erreurFatale("alloc deltas");
+    char ligne[256];
+    *nb = 0;
+    *invalides = 0;
+    while (fgets(ligne, sizeof(ligne), f)) {
+        char op;
+        t_delta x;
+        x.proba = 0.0f;
+        if (sscanf(ligne, " %c", &op) != 1 || op == '#') continue;
+        int lus = sscanf(ligne, " %c %d %d %f", &op, &x.depart, &x.arrivee, &x.proba);
+        if (op == '+' && lus == 4) x.type = DELTA_AJOUT;
+        else if (op == '=' && lus == 4) x.type = DELTA_POIDS;
+        else if (op == '-' && lus >= 3) x.type = DELTA_SUPPRESSION;
+        else { (*invalides)++; continue; }
+        if (*nb == cap) {
+            cap *= 2;
+            t_delta *n = (t_delta*)realloc(d, cap * sizeof(t_delta));
+            if (!n) erreurFatale("alloc deltas");
+            d = n;
+        }
+        d[(*nb)++] = x;
+    }
+    fclose(f);
+    *deltas = d;
+    return 0;
+}
@@ -0,0 +1,308 @@
+#include "ingest.h"
+
+#define TAILLE_LECTURE (1 << 20)
+
+/* arête lue, avant rangement par ligne */
+typedef struct {
+    int depart, arrivee;
+    float proba;
+} t_lue;
+
+/* arête rangée dans sa ligne */
+typedef struct {
+    int arrivee;
+    float proba;
+} t_rangee;
+
+void optionsIngestParDefaut(t_options_ingest *opt) {
+    opt->renormaliser = 0;
+    opt->tolerance = 0.01f;   // comme verifierMarkov
+    opt->trier = 1;
+}
+
+/* 1 si le graphe chargé est une chaîne de Markov valide et sans anomalie de lecture */
+int rapportValide(const t_rapport_ingest *r) {
+    return r->statut == GRAPHE_OK && r->lignes_invalides == 0 && r->hors_intervalle == 0 &&
+           r->probas_invalides == 0 && r->lignes_hors_somme == 0;
+}
+
+static int lireEntier(const char **pp, const char *fin, long *v) {
+    const char *p = *pp;
+    while (p < fin && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    int neg = 0;
+    if (p < fin && (*p == '-' || *p == '+')) neg = *p++ == '-';
+    if (p >= fin || *p < '0' || *p > '9') return 0;
+    long x = 0;
+    while (p < fin && *p >= '0' && *p <= '9') {
+        if (x < 1000000000000L) x = x * 10 + (*p - '0');
+        p++;
+    }
+    *v = neg ? -x : x;
+    *pp = p;
+    return 1;
+}
+
+static int comparerRangees(const void *a, const void *b) {
+    int x = ((const t_rangee*)a)->arrivee, y = ((const t_rangee*)b)->arrivee;
+    return (x > y) - (x < y);
+}
+
+/* tri par arrivée : insertion pour les lignes courtes, qsort au-delà */
+static void trierLigne(t_rangee *t, long nb) {
+    if (nb > 16) {
+        qsort(t, nb, sizeof(t_rangee), comparerRangees);
+        return;
+    }
+    for (long a = 1; a < nb; a++) {
+        t_rangee x = t[a];
+        long b = a - 1;
+        while (b >= 0 && t[b].arrivee > x.arrivee) {
+            t[b + 1] = t[b];
+            b--;
+        }
+        t[b + 1] = x;
+    }
+}
+
+/* analyse une ligne [p, eol) ; le tampon est terminé par '\0' après la dernière ligne */
+static void analyserLigne(const char *p, const char *eol, int n, t_lue **lues, long long *nb, long long *cap,
+                          long *degre, t_rapport_ingest *r) {
+    r->lignes++;
+    long d, a;
+    if (!lireEntier(&p, eol, &d) || !lireEntier(&p, eol, &a)) {
+        r->lignes_invalides++;
+        return;
+    }
+    char *apres;
+    float proba = strtof(p, &apres);
+    if (apres == p || apres > eol) {   // strtof sauterait le '\n' pour lire la ligne suivante
+        r->lignes_invalides++;
+        return;
+    }
+    if (d < 1 || d > n || a < 1 || a > n) {
+        r->hors_intervalle++;
+        return;
+    }
+    if (!(proba >= 0.0f && proba <= 1.0f)) {
+        r->probas_invalides++;
+        return;
+    }
+    if (proba == 0.0f) {
+        r->probas_nulles++;
+        return;
+    }
+    if (*nb == *cap) {
+        *cap *= 2;
+        oublierRessource(*lues);
+        t_lue *t = (t_lue*)realloc(*lues, *cap * sizeof(t_lue));
+        suivreRessource(t ? t : *lues, free);
+        if (!t) erreurFatale("alloc ingestion");
+        *lues = t;
+    }
+    (*lues)[*nb].depart = (int)d;
+    (*lues)[*nb].arrivee = (int)a;
+    (*lues)[*nb].proba = proba;
+    (*nb)++;
+    degre[d]++;
+}
+
+static int ligneVide(const char *p, const char *eol) {
+    while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    return p == eol;
+}
+
+/* construit une ligne : fusion des doublons dans la première occurrence
+   (marque[a] == sommet si l'arrivée a est déjà vue, à la place place[a]),
+   contrôle de la somme, renormalisation éventuelle, tri si demandé, puis
+   insertion en tête (de la plus grande arrivée à la plus petite si triée,
+   sinon dans l'ordre du fichier, comme ajouterCellule dans l'ancien readGraph) */
+static void construireLigne(liste *l, int sommet, t_rangee *t, long nb, int *marque, long *place,
+                            const t_options_ingest *opt, t_rapport_ingest *r) {
+    if (nb == 0) r->lignes_vides++;   // somme nulle : hors tolérance, comme dans verifierMarkov
+    long m = 0;
+    float somme = 0.0f;
+    for (long k = 0; k < nb; k++) {
+        int a = t[k].arrivee;
+        if (marque[a] == sommet) {
+            t[place[a]].proba += t[k].proba;
+            r->doublons++;
+        } else {
+            marque[a] = sommet;
+            place[a] = m;
+            t[m++] = t[k];
+        }
+        somme += t[k].proba;
+    }
+    float ecart = fabsf(somme - 1.0f);
+    if (ecart > opt->tolerance) {
+        if (r->lignes_hors_somme++ == 0) r->premier_hors_somme = sommet;
+    }
+    if (r->pire_sommet == 0 || ecart > fabsf(r->pire_somme - 1.0f)) {
+        r->pire_sommet = sommet;
+        r->pire_somme = somme;
+    }
+    int renormaliser = opt->renormaliser && somme > 0.0f && somme != 1.0f;
+    if (renormaliser) r->renormalisees++;
+    if (opt->trier) {
+        trierLigne(t, m);
+        for (long k = m - 1; k >= 0; k--) {
+            ajouterCellule(l, t[k].arrivee, renormaliser ? t[k].proba / somme : t[k].proba);
+        }
+    } else {
+        for (long k = 0; k < m; k++) {
+            ajouterCellule(l, t[k].arrivee, renormaliser ? t[k].proba / somme : t[k].proba);
+        }
+    }
+    r->aretes += m;
+}
+
+/* ingererGraphe
+ Renvoie GRAPHE_OK (le graphe est alors dans *out), GRAPHE_ERR_FICHIER ou
+ GRAPHE_ERR_FORMAT (nombre de sommets absent ou invalide) ; le même statut
+ est dans rapport->statut. opt peut être NULL (optionsIngestParDefaut).
+ */
+int ingererGraphe(const char *fichier, const t_options_ingest *opt, liste_adjacence *out,
+                  t_rapport_ingest *rapport) {
+    t_options_ingest defaut;
+    if (!opt) {
+        optionsIngestParDefaut(&defaut);
+        opt = &defaut;
+    }
+    t_rapport_ingest *r = rapport;
+    memset(r, 0, sizeof(*r));
+    FILE *f = fopen(fichier, "rb");
+    if (!f) return r->statut = GRAPHE_ERR_FICHIER;
+    suivreRessource(f, ressourceFichier);
+
+    char *tampon = (char*)malloc(TAILLE_LECTURE + 1);
+    long long nb = 0, cap = 1 << 16;
+    t_lue *lues = (t_lue*)malloc(cap * sizeof(t_lue));
+    suivreRessource(tampon, free);
+    suivreRessource(lues, free);
+    if (!tampon || !lues) erreurFatale("alloc ingestion");
+    long *degre = NULL;
+    int n = 0, erreur = 0;
+    size_t reste = 0;   // début de ligne incomplète recopié en tête du tampon
+    int sauter = 0;     // fin d'une ligne trop longue à ignorer
+    for (;;) {
+        size_t lu = fread(tampon + reste, 1, TAILLE_LECTURE - reste, f);
+        size_t len = reste + lu;
+        int dernier = lu == 0;
+        tampon[len] = '\0';
+        const char *p = tampon, *fin = tampon + len;
+        if (sauter) {
+            /* suite de la ligne trop longue : ignorée jusqu'au prochain '\n' */
+            const char *eol = (const char*)memchr(p, '\n', len);
+            if (eol) {
+                p = eol + 1;
+                sauter = 0;
+            } else {
+                p = fin;
+            }
+        }
+        while (p < fin) {
+            const char *eol = (const char*)memchr(p, '\n', (size_t)(fin - p));
+            if (!eol) {
+                if (!dernier) break;
+                eol = fin;
+            }
+            if (!degre) {
+                long v;
+                const char *q = p;
+                if (lireEntier(&q, eol, &v)) {
+                    if (v <= 0 || v > 1000000000L) {
+                        erreur = 1;
+                        break;
+                    }
+                    n = (int)v;
+                    degre = (long*)calloc((size_t)n + 1, sizeof(long));
+                    if (!degre) erreurFatale("alloc ingestion");
+                    suivreRessource(degre, free);
+                } else if (!ligneVide(p, eol)) {
+                    erreur = 1;
+                    break;
+                }
+            } else if (!ligneVide(p, eol)) {
+                analyserLigne(p, eol, n, &lues, &nb, &cap, degre, r);
+            }
+            p = eol < fin ? eol + 1 : fin;
+        }
+        if (erreur || dernier) break;
+        reste = (size_t)(fin - p);
+        if (reste == TAILLE_LECTURE) {
+            /* ligne de plus d'un tampon : invalide, on la saute */
+            r->lignes++;
+            r->lignes_invalides++;
+            reste = 0;
+            sauter = 1;
+        } else {
+            memmove(tampon, p, reste);
+        }
+    }
+    oublierRessource(f);
+    oublierRessource(tampon);
+    fclose(f);
+    free(tampon);
+    if (erreur || !degre) {
+        oublierRessource(lues);
+        oublierRessource(degre);
+        free(lues);
+        free(degre);
+        return r->statut = GRAPHE_ERR_FORMAT;
+    }
+    r->n = n;
+
+    /* rangement par ligne (tri par comptage) : la ligne i occupe [debut[i-1], debut[i]) */
+    long *debut = (long*)malloc(((size_t)n + 1) * sizeof(long));
+    t_rangee *rangees = (t_rangee*)malloc((nb + 1) * sizeof(t_rangee));
+    suivreRessource(debut, free);
+    suivreRessource(rangees, free);
+    if (!debut || !rangees) erreurFatale("alloc ingestion");
+    debut[0] = 0;
+    for (int i = 1; i <= n; i++) {
+        debut[i] = debut[i - 1] + degre[i];
+        degre[i] = debut[i - 1];   // position d'écriture
+    }
+    for (long long k = 0; k < nb; k++) {
+        long pos = degre[lues[k].depart]++;
+        rangees[pos].arrivee = lues[k].arrivee;
+        rangees[pos].proba = lues[k].proba;
+    }
+    oublierRessource(lues);
+    free(lues);
+    /* degre est réutilisé comme place[] des arrivées pour la fusion */
+    int *marque = (int*)calloc((size_t)n + 1, sizeof(int));
+    suivreRessource(marque, free);
+    if (!marque) erreurFatale("alloc ingestion");
+
+    liste_adjacence la = creerListeAdjacence(n);
+    suivreRessource(&la, ressourceListe);
+    for (int i = 1; i <= n; i++) {
+        construireLigne(&la.tab[i - 1], i, rangees + debut[i - 1], debut[i] - debut[i - 1], marque, degre,
+                        opt, r);
+    }
+    oublierRessource(&la);
+    oublierRessource(marque);
+    oublierRessource(degre);
+    free(marque);
+    free(degre);
+    oublierRessource(rangees);
+    oublierRessource(debut);
+    free(rangees);
+    free(debut);
+    *out = la;
+    return r->statut = GRAPHE_OK;
+}
+
+/* affiche les compteurs du rapport (sans le verdict, cf. rapportValide) */
+void afficherRapportIngest(const t_rapport_ingest *r) {
+    printf("  %d sommets, %lld lignes d'arêtes, %lld arêtes retenues\n", r->n, r->lignes, r->aretes);
+    printf("  lignes invalides : %lld, sommets hors intervalle : %lld, probabilités invalides : %lld\n",
+           r->lignes_invalides, r->hors_intervalle, r->probas_invalides);
+    printf("  probabilités nulles retirées : %lld, doublons fusionnés : %lld\n", r->probas_nulles, r->doublons);
+    printf("  sommets sans arête sortante : %d\n", r->lignes_vides);
+    printf("  sommes hors tolérance : %d", r->lignes_hors_somme);
+    if (r->lignes_hors_somme > 0) printf(" (premier : sommet %d)", r->premier_hors_somme);
+    printf("\n");
+    if (r->pire_sommet > 0) printf("  pire somme : %.6f (sommet %d)\n", r->pire_somme, r->pire_sommet);
+}
@@ -0,0 +1,212 @@
+#include "lookup.h"
+
+/* même mélange que la table d'estimation (moitiés du produit repliées) */
+static inline size_t caseArete(uint64_t cle, size_t cap) {
+    uint64_t h = cle * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(h ^ (h >> 32)) & (cap - 1);
+}
+
+/* construireIndexAretes
+ Les arêtes en double (possibles dans une liste construite arête par arête,
+ cf. markov_charger_aretes) sont fusionnées en additionnant leurs
+ probabilités, comme le fait la matrice ; le logarithme est calculé une
+ fois toutes les arêtes insérées.
+ */
+t_index_aretes construireIndexAretes(liste_adjacence la) {
+    t_index_aretes idx;
+    idx.n = la.taille;
+    idx.nb_aretes = 0;
+    long nnz = 0;
+    for (int i = 0; i < la.taille; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) nnz++;
+    }
+    idx.cap = 16;
+    while (idx.cap < (size_t)nnz * 4) idx.cap <<= 1;
+    idx.cases = (t_case_arete*)calloc(idx.cap, sizeof(t_case_arete));
+    if (!idx.cases) erreurFatale("alloc index aretes");
+    for (int i = 0; i < la.taille; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) {
+            uint64_t cle = ((uint64_t)(i + 1) << 32) | (uint32_t)c->arrivee;
+            size_t h = caseArete(cle, idx.cap);
+            while (idx.cases[h].cle && idx.cases[h].cle != cle) h = (h + 1) & (idx.cap - 1);
+            if (idx.cases[h].cle) {
+                idx.cases[h].proba += c->proba;
+                continue;
+            }
+            idx.cases[h].cle = cle;
+            idx.cases[h].proba = c->proba;
+            idx.nb_aretes++;
+        }
+    }
+    for (size_t h = 0; h < idx.cap; h++) {
+        if (!idx.cases[h].cle) continue;
+        float p = idx.cases[h].proba;
+        idx.cases[h].log_proba = p > 0.0f ? logf(p) : -INFINITY;
+    }
+    return idx;
+}
+
+/* case de l'arête (depart -> arrivee), NULL si absente */
+static inline const t_case_arete *chercherArete(const t_case_arete *cases, size_t cap,
+                                                 uint64_t cle) {
+    size_t h = caseArete(cle, cap);
+    while (cases[h].cle != cle) {
+        if (!cases[h].cle) return NULL;
+        h = (h + 1) & (cap - 1);
+    }
+    return &cases[h];
+}
+
+/* P(depart -> arrivee), sommets 1-based ; 0 si l'arête n'existe pas */
+float probaArete(const t_index_aretes *idx, int depart, int arrivee) {
+    if (depart < 1 || depart > idx->n || arrivee < 1 || arrivee > idx->n) return 0.0f;
+    uint64_t cle = ((uint64_t)depart << 32) | (uint32_t)arrivee;
+    const t_case_arete *c = chercherArete(idx->cases, idx->cap, cle);
+    return c ? c->proba : 0.0f;
+}
+
+/* distance de préchargement (en pas de trajectoire) */
+#define LOOKUP_AVANCE 16
+
+/* trajectoires [premiere, derniere) */
+typedef struct {
+    const t_index_aretes *idx;
+    const int *etats;
+    const long *debut;
+    t_score *scores;
+    int premiere, derniere;
+} t_tache_score;
+
+static void scorerTranche(void *arg) {
+    t_tache_score *t = (t_tache_score*)arg;
+    const t_case_arete *cases = t->idx->cases;
+    size_t cap = t->idx->cap;
+    const int *etats = t->etats;
+    unsigned n = (unsigned)t->idx->n;
+    for (int r = t->premiere; r < t->derniere; r++) {
+        double lv = 0.0;
+        long inconnues = 0, premiere = -1;
+        long fin = t->debut[r + 1];
+        for (long e = t->debut[r]; e + 1 < fin; e++) {
+            /* les transitions à venir sont connues : on précharge leur case */
+            if (e + LOOKUP_AVANCE + 1 < fin) {
+                uint64_t cle = ((uint64_t)(uint32_t)etats[e + LOOKUP_AVANCE] << 32)
+                             | (uint32_t)etats[e + LOOKUP_AVANCE + 1];
+                __builtin_prefetch(&cases[caseArete(cle, cap)]);
+            }
+            unsigned i = (unsigned)etats[e], j = (unsigned)etats[e + 1];
+            const t_case_arete *c = NULL;
+            if (i - 1 < n && j - 1 < n) c = chercherArete(cases, cap, ((uint64_t)i << 32) | j);
+            /* une probabilité nulle a pour logarithme -inf : traitée comme absente */
+            float l = c ? c->log_proba : -INFINITY;
+            if (l != -INFINITY) {
+                lv += l;
+            } else {
+                if (premiere < 0) premiere = e - t->debut[r];
+                inconnues++;
+            }
+        }
+        t->scores[r].log_vraisemblance = lv;
+        t->scores[r].inconnues = inconnues;
+        t->scores[r].premiere_inconnue = premiere;
+    }
+}
+
+/* scorerTrajectoires
+ La trajectoire r est etats[debut[r] .. debut[r+1]-1] (sommets 1-based).
+ Avec un ordonnanceur, les trajectoires sont réparties en tranches de même
+ nombre de transitions ; sans (o = NULL), le calcul est séquentiel.
+ */
+void scorerTrajectoires(const t_index_aretes *idx, const int *etats, const long *debut, int nb,
+                        t_score *scores, t_ordonnanceur *o) {
+    int nb_tranches = o ? 4 * (nombreWorkers(o) + 1) : 1;
+    if (nb_tranches > nb) nb_tranches = nb > 0 ? nb : 1;
+    t_tache_score *taches = (t_tache_score*)malloc(nb_tranches * sizeof(t_tache_score));
+    if (!taches) erreurFatale("alloc score");
+    long total = debut[nb] - debut[0];
+    int r = 0;
+    for (int k = 0; k < nb_tranches; k++) {
+        long cible = debut[0] + total * (k + 1) / nb_tranches;
+        taches[k].idx = idx;
+        taches[k].etats = etats;
+        taches[k].debut = debut;
+        taches[k].scores = scores;
+        taches[k].premiere = r;
+        while (r < nb && (debut[r] < cible || k == nb_tranches - 1)) r++;
+        taches[k].derniere = r;
+    }
+    if (o) {
+        t_groupe g;
+        initGroupe(&g);
+        for (int k = 0; k < nb_tranches; k++) {
+            if (taches[k].derniere > taches[k].premiere) soumettreTache(o, &g, scorerTranche, &taches[k]);
+        }
+        attendreGroupe(o, &g);
+    } else {
+        for (int k = 0; k < nb_tranches; k++) scorerTranche(&taches[k]);
+    }
+    free(taches);
+}
+
+/* lireTrajectoires
+ Une trajectoire par ligne (états séparés par des blancs, virgules ou
+ points-virgules, lignes vides et commençant par '#' ignorées). Renvoie 0, -1
+ si le fichier est illisible ; *etats et *debut sont à libérer par l'appelant.
+ */
+int lireTrajectoires(const char *fichier, int **etats, long **debut, int *nb) {
+    FILE *f = fopen(fichier, "rb");
+    if (!f) return -1;
+    long cap_e = 1024, nb_e = 0;
+    int cap_t = 64, nb_t = 0;
+    int *e = (int*)malloc(cap_e * sizeof(int));
+    long *d = (long*)malloc((cap_t + 1) * sizeof(long));
+    if (!e || !d) erreurFatale("alloc trajectoires");
+    d[0] = 0;
+    int c, valeur = 0, dans_nombre = 0, commentaire = 0, debut_ligne = 1;
+    do {
+        c = getc(f);
+        if (!commentaire && c >= '0' && c <= '9') {
+            valeur = valeur * 10 + (c - '0');
+            dans_nombre = 1;
+            debut_ligne = 0;
+            continue;
+        }
+        if (dans_nombre) {
+            if (nb_e == cap_e) {
+                cap_e *= 2;
+                int *n = (int*)realloc(e, cap_e * sizeof(int));
+                if (!n) erreurFatale("alloc trajectoires");
+                e = n;
+            }
+            e[nb_e++] = valeur;
+            valeur = 0;
+            dans_nombre = 0;
+        }
+        if (c == '#' && debut_ligne) commentaire = 1;
+        if (c == '\n' || c == EOF) {
+            if (nb_e > d[nb_t]) {
+                if (nb_t == cap_t) {
+                    cap_t *= 2;
+                    long *n = (long*)realloc(d, (cap_t + 1) * sizeof(long));
+                    if (!n) erreurFatale("alloc trajectoires");
+                    d = n;
+                }
+                d[++nb_t] = nb_e;
+            }
+            commentaire = 0;
+            debut_ligne = 1;
+        }
+    } while (c != EOF);
+    fclose(f);
+    *etats = e;
+    *debut = d;
+    *nb = nb_t;
+    return 0;
+}
+
+void libererIndexAretes(t_index_aretes *idx) {
+    if (!idx) return;
+    free(idx->cases);
+    idx->cases = NULL;
+    idx->cap = 0;
+}
@@ -0,0 +1,382 @@
+#include "lump.h"
+#include "matrix.h"
+
+/* partition raffinable : les états de chaque bloc sont contigus dans 'elems' */
+typedef struct {
+    int n, nb;
+    int *elems;       // permutation des états (0-based)
+    int *pos;         // pos[s] = indice de s dans elems
+    int *bloc;        // bloc[s] (0-based)
+    int *debut, *fin; // bloc b = elems[debut[b] .. fin[b]-1]
+    char *en_file;    // 1 si le bloc attend d'être utilisé comme séparateur
+} t_raffinable;
+
+/* arêtes au format CSR (0-based), dans un sens ou dans l'autre */
+typedef struct {
+    int *debut;
+    int *voisin;
+    float *proba;
+} t_aretes;
+
+typedef struct {
+    int etat;
+    double poids;
+} t_touche;
+
+/* tampons de travail partagés par les étapes de raffinement */
+typedef struct {
+    double *poids;       // poids[s] vers (ou depuis) le séparateur courant
+    char *marque;        // 1 si s est dans liste
+    int *liste;          // états touchés par le séparateur
+    int *blocs;          // blocs contenant au moins un état touché
+    int *nb_touches;     // nb_touches[b] pendant une étape
+    t_touche *touches;
+    int_stack file;      // blocs séparateurs en attente
+    float tolerance;
+} t_travail;
+
+static int comparerTouches(const void *a, const void *b) {
+    const t_touche *x = (const t_touche*)a;
+    const t_touche *y = (const t_touche*)b;
+    if (x->poids < y->poids) return -1;
+    if (x->poids > y->poids) return 1;
+    return x->etat - y->etat;
+}
+
+/* sortantes = liste d'adjacence ; entrantes = transposée */
+static t_aretes construireAretes(liste_adjacence la, int entrantes) {
+    int n = la.taille;
+    t_aretes e;
+    e.debut = (int*)calloc(n + 1, sizeof(int));
+    if (!e.debut) erreurFatale("alloc aretes");
+    for (int i = 0; i < n; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) {
+            e.debut[entrantes ? c->arrivee : i + 1]++;
+        }
+    }
+    for (int t = 1; t <= n; t++) e.debut[t] += e.debut[t - 1];
+    e.voisin = (int*)malloc((e.debut[n] + 1) * sizeof(int));
+    e.proba = (float*)malloc((e.debut[n] + 1) * sizeof(float));
+    int *pos = (int*)malloc((n + 1) * sizeof(int));
+    if (!e.voisin || !e.proba || !pos) erreurFatale("alloc aretes");
+    memcpy(pos, e.debut, (n + 1) * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) {
+            int k = entrantes ? pos[c->arrivee - 1]++ : pos[i]++;
+            e.voisin[k] = entrantes ? i : c->arrivee - 1;
+            e.proba[k] = c->proba;
+        }
+    }
+    free(pos);
+    return e;
+}
+
+static void libererAretes(t_aretes *e) {
+    free(e->debut);
+    free(e->voisin);
+    free(e->proba);
+}
+
+/* déplace l'état s en fin de son bloc puis le détache dans le bloc 'nouveau' */
+static void detacher(t_raffinable *r, int s, int nouveau) {
+    int b = r->bloc[s];
+    int dernier = r->fin[b] - 1;
+    int autre = r->elems[dernier];
+    int ps = r->pos[s];
+    r->elems[ps] = autre;
+    r->pos[autre] = ps;
+    r->elems[dernier] = s;
+    r->pos[s] = dernier;
+    r->fin[b]--;
+    r->debut[nouveau] = r->fin[b];
+    r->bloc[s] = nouveau;
+}
+
+static void mettreEnFile(t_raffinable *r, t_travail *w, int b) {
+    if (r->en_file[b]) return;
+    r->en_file[b] = 1;
+    push_stack(&w->file, b);
+}
+
+/* coupe le bloc b selon le poids de ses états touchés (déjà triés dans w->touches[0..nt-1]).
+ Le morceau de poids nul (non touchés et poids ~0) reste dans b, à défaut le dernier groupe. */
+static void couperBloc(t_raffinable *r, t_travail *w, int b, t_touche *touches, int nt) {
+    int taille_b = r->fin[b] - r->debut[b];
+    int nb_nuls = taille_b - nt;
+    int g0 = 0;
+    while (g0 < nt && touches[g0].poids <= w->tolerance) g0++;
+    nb_nuls += g0;
+    if (g0 == nt && nb_nuls == taille_b) return;
+
+    int deja_en_file = r->en_file[b];
+    int premier = r->nb;
+    int plus_grand = nb_nuls;
+    int bloc_plus_grand = b;
+    for (int k = g0 + 1; k <= nt; k++) {
+        if (k < nt && touches[k].poids - touches[k - 1].poids <= w->tolerance) continue;
+        int taille_g = k - g0;
+        if (taille_g == taille_b) return;          // un seul groupe : b est stable
+        if (k == nt && nb_nuls == 0) {
+            /* dernier groupe et pas de morceau nul : il reste dans b */
+            if (taille_g > plus_grand) {
+                plus_grand = taille_g;
+                bloc_plus_grand = b;
+            }
+            break;
+        }
+        int nouveau = r->nb++;
+        r->en_file[nouveau] = 0;
+        for (int j = g0; j < k; j++) detacher(r, touches[j].etat, nouveau);
+        r->fin[nouveau] = r->debut[nouveau] + taille_g;
+        if (taille_g > plus_grand) {
+            plus_grand = taille_g;
+            bloc_plus_grand = nouveau;
+        }
+        g0 = k;
+    }
+    /* b était en attente : tous les morceaux le sont ; sinon b était stable
+       et il suffit de traiter tous les morceaux sauf le plus grand */
+    if (!deja_en_file && bloc_plus_grand != b) mettreEnFile(r, w, b);
+    for (int nv = premier; nv < r->nb; nv++) {
+        if (deja_en_file || nv != bloc_plus_grand) mettreEnFile(r, w, nv);
+    }
+}
+
+/* une étape de raffinement : coupe tous les blocs selon leur poids vers le séparateur
+ (aretes = entrantes) ou depuis le séparateur (aretes = sortantes) */
+static void raffiner(t_raffinable *r, t_travail *w, t_aretes *e, int sep) {
+    int nb_liste = 0;
+    for (int k = r->debut[sep]; k < r->fin[sep]; k++) {
+        int t = r->elems[k];
+        for (int a = e->debut[t]; a < e->debut[t + 1]; a++) {
+            int s = e->voisin[a];
+            if (!w->marque[s]) {
+                w->marque[s] = 1;
+                w->liste[nb_liste++] = s;
+            }
+            w->poids[s] += e->proba[a];
+        }
+    }
+    int nb_blocs = 0;
+    for (int k = 0; k < nb_liste; k++) {
+        int b = r->bloc[w->liste[k]];
+        if (w->nb_touches[b]++ == 0) w->blocs[nb_blocs++] = b;
+    }
+    /* regroupe les états touchés par bloc : décalages cumulés dans nb_touches */
+    int total = 0;
+    for (int ib = 0; ib < nb_blocs; ib++) {
+        int b = w->blocs[ib];
+        int c = w->nb_touches[b];
+        w->nb_touches[b] = total;
+        total += c;
+    }
+    for (int k = 0; k < nb_liste; k++) {
+        int s = w->liste[k];
+        int i = w->nb_touches[r->bloc[s]]++;
+        w->touches[i].etat = s;
+        w->touches[i].poids = w->poids[s];
+    }
+    for (int k = 0; k < nb_liste; k++) {
+        w->poids[w->liste[k]] = 0.0;
+        w->marque[w->liste[k]] = 0;
+    }
+    /* nb_touches[b] vaut maintenant la fin de la tranche de b dans touches */
+    int deb = 0;
+    for (int ib = 0; ib < nb_blocs; ib++) {
+        int b = w->blocs[ib];
+        int fin = w->nb_touches[b];
+        w->nb_touches[b] = 0;
+        qsort(w->touches + deb, fin - deb, sizeof(t_touche), comparerTouches);
+        couperBloc(r, w, b, w->touches + deb, fin - deb);
+        deb = fin;
+    }
+}
+/* calculerAgregation
+ etiquettes (taille n, 0-based, peut être NULL) impose une partition initiale
+ (ex. : récompenses) ; deux poids sont égaux s'ils diffèrent d'au plus 'tolerance'.
+ mode = LUMP_ORDINAIRE : seuls les poids sortants séparent les états ;
+ mode = LUMP_STRICT : les poids entrants aussi, la partition est alors exactement
+ lumpable et la distribution stationnaire est uniforme dans chaque bloc.
+ */
+t_agregation calculerAgregation(liste_adjacence la, const int *etiquettes, int mode, float tolerance) {
+    int n = la.taille;
+    t_raffinable r;
+    t_travail w;
+    r.n = n;
+    r.elems = (int*)malloc((n + 1) * sizeof(int));
+    r.pos = (int*)malloc((n + 1) * sizeof(int));
+    r.bloc = (int*)malloc((n + 1) * sizeof(int));
+    r.debut = (int*)malloc((n + 1) * sizeof(int));
+    r.fin = (int*)malloc((n + 1) * sizeof(int));
+    r.en_file = (char*)calloc(n + 1, sizeof(char));
+    w.poids = (double*)calloc(n + 1, sizeof(double));
+    w.marque = (char*)calloc(n + 1, sizeof(char));
+    w.liste = (int*)malloc((n + 1) * sizeof(int));
+    w.blocs = (int*)malloc((n + 1) * sizeof(int));
+    w.nb_touches = (int*)calloc(n + 1, sizeof(int));
+    w.touches = (t_touche*)malloc((n + 1) * sizeof(t_touche));
+    w.tolerance = tolerance;
+    if (!r.elems || !r.pos || !r.bloc || !r.debut || !r.fin || !r.en_file || !w.poids ||
+        !w.marque || !w.liste || !w.blocs || !w.nb_touches || !w.touches) {
+        erreurFatale("alloc agregation");
+    }
+
+    /* partition initiale : un bloc, ou un bloc par étiquette */
+    for (int s = 0; s < n; s++) {
+        w.touches[s].etat = s;
+        w.touches[s].poids = etiquettes ? (double)etiquettes[s] : 0.0;
+    }
+    qsort(w.touches, n, sizeof(t_touche), comparerTouches);
+    r.nb = 0;
+    for (int k = 0; k < n; k++) {
+        if (k == 0 || w.touches[k].poids != w.touches[k - 1].poids) {
+            if (r.nb > 0) r.fin[r.nb - 1] = k;
+            r.debut[r.nb++] = k;
+        }
+        r.elems[k] = w.touches[k].etat;
+        r.pos[w.touches[k].etat] = k;
+        r.bloc[w.touches[k].etat] = r.nb - 1;
+    }
+    if (r.nb > 0) r.fin[r.nb - 1] = n;
+
+    init_stack(&w.file);
+    for (int b = 0; b < r.nb; b++) mettreEnFile(&r, &w, b);
+
+    t_aretes entrantes = construireAretes(la, 1);
+    t_aretes sortantes;
+    if (mode == LUMP_STRICT) sortantes = construireAretes(la, 0);
+    while (!stack_empty(&w.file)) {
+        int sep = pop_stack(&w.file);
+        r.en_file[sep] = 0;
+        raffiner(&r, &w, &entrantes, sep);
+        if (mode == LUMP_STRICT) raffiner(&r, &w, &sortantes, sep);
+    }
+    free_stack(&w.file);
+    if (mode == LUMP_STRICT) libererAretes(&sortantes);
+
+    t_agregation ag;
+    ag.n = n;
+    ag.nb_blocs = r.nb;
+    ag.bloc_de = (int*)malloc((n + 1) * sizeof(int));
+    ag.taille = (int*)calloc(r.nb + 1, sizeof(int));
+    if (!ag.bloc_de || !ag.taille) erreurFatale("alloc agregation");
+    for (int s = 0; s < n; s++) {
+        ag.bloc_de[s + 1] = r.bloc[s] + 1;
+        ag.taille[r.bloc[s] + 1]++;
+    }
+
+    /* lumpabilité exacte : pour tout bloc B, la masse entrante sum_{s in B} P(s,t)
+       doit être la même pour tous les états t d'un même bloc */
+    ag.exacte = 1;
+    double *entrant = w.poids;     // réutilisé, indexé par bloc source
+    for (int c = 0; c < r.nb && ag.exacte; c++) {
+        int ref = r.elems[r.debut[c]];
+        for (int k = r.debut[c] + 1; k < r.fin[c] && ag.exacte; k++) {
+            int t = r.elems[k];
+            for (int a = entrantes.debut[ref]; a < entrantes.debut[ref + 1]; a++) {
+                entrant[r.bloc[entrantes.voisin[a]]] += entrantes.proba[a];
+            }
+            for (int a = entrantes.debut[t]; a < entrantes.debut[t + 1]; a++) {
+                entrant[r.bloc[entrantes.voisin[a]]] -= entrantes.proba[a];
+            }
+            for (int a = entrantes.debut[ref]; a < entrantes.debut[ref + 1]; a++) {
+                int b = r.bloc[entrantes.voisin[a]];
+                if (fabs(entrant[b]) > tolerance) ag.exacte = 0;
+                entrant[b] = 0.0;
+            }
+            for (int a = entrantes.debut[t]; a < entrantes.debut[t + 1]; a++) {
+                int b = r.bloc[entrantes.voisin[a]];
+                if (fabs(entrant[b]) > tolerance) ag.exacte = 0;
+                entrant[b] = 0.0;
+            }
+        }
+    }
+
+    libererAretes(&entrantes);
+    free(w.poids);
+    free(w.marque);
+    free(w.liste);
+    free(w.blocs);
+    free(w.nb_touches);
+    free(w.touches);
+    free(r.elems);
+    free(r.pos);
+    free(r.bloc);
+    free(r.debut);
+    free(r.fin);
+    free(r.en_file);
+    return ag;
+}
+
+/* chaîne quotient (sommets = blocs) : ligne d'un représentant de chaque bloc */
+liste_adjacence grapheQuotient(liste_adjacence la, t_agregation *ag) {
+    liste_adjacence q = creerListeAdjacence(ag->nb_blocs);
+    int *vu = (int*)calloc(ag->nb_blocs + 1, sizeof(int));
+    float *somme = (float*)calloc(ag->nb_blocs + 1, sizeof(float));
+    if (!vu || !somme) erreurFatale("alloc quotient");
+    for (int s = 1; s <= ag->n; s++) {
+        int b = ag->bloc_de[s];
+        if (vu[b]) continue;
+        vu[b] = 1;
+        for (cellule *c = la.tab[s - 1].head; c; c = c->suivant) {
+            somme[ag->bloc_de[c->arrivee]] += c->proba;
+        }
+        for (cellule *c = la.tab[s - 1].head; c; c = c->suivant) {
+            int d = ag->bloc_de[c->arrivee];
+            if (somme[d] != 0.0f) {
+                ajouterCellule(&q.tab[b - 1], d, somme[d]);
+                somme[d] = 0.0f;
+            }
+        }
+    }
+    free(vu);
+    free(somme);
+    return q;
+}
+
+/* p_blocs[b-1] = somme des p_etats du bloc b */
+void agregerDistribution(t_agregation *ag, const float *p_etats, float *p_blocs) {
+    for (int b = 0; b < ag->nb_blocs; b++) p_blocs[b] = 0.0f;
+    for (int s = 1; s <= ag->n; s++) p_blocs[ag->bloc_de[s] - 1] += p_etats[s - 1];
+}
+
+/* répartit uniformément la masse de chaque bloc entre ses états
+ (exact pour une partition exactement lumpable, approximation sinon) */
+void releverDistribution(t_agregation *ag, const float *p_blocs, float *p_etats) {
+    for (int s = 1; s <= ag->n; s++) {
+        int b = ag->bloc_de[s];
+        p_etats[s - 1] = p_blocs[b - 1] / ag->taille[b];
+    }
+}
+
+/* stationnaireParAgregation
+ pi (taille n) contient la distribution de départ et reçoit le résultat. La chaîne
+ quotient est itérée depuis les masses par bloc de pi (même trajectoire agrégée
+ que la chaîne complète), puis le résultat est relevé ; les masses par bloc sont
+ exactes. Si la partition n'est pas exactement lumpable, la répartition dans
+ les blocs est corrigée par des itérations sur la chaîne complète, qui
+ conservent les masses par bloc et partent donc de très près de la solution.
+ Les deux résolutions suivent 'prec'. Renvoie le nombre total d'itérations
+ (chaîne quotient, plus chaîne complète si la partition n'est pas exacte).
+ */
+int stationnaireParAgregation(liste_adjacence la, t_agregation *ag, float *pi, float epsilon, int max_iter,
+                              t_precision prec) {
+    liste_adjacence q = grapheQuotient(la, ag);
+    float *pq = createZeroVector(ag->nb_blocs);
+    agregerDistribution(ag, pi, pq);
+    int iter = puissanceAdjacence(q, pq, epsilon, max_iter, prec);
+    releverDistribution(ag, pq, pi);
+    freeVector(pq);
+    free_liste_adjacence(&q);
+    if (ag->exacte) return iter;
+    return iter + puissanceAdjacence(la, pi, epsilon, max_iter, prec);
+}
+
+void libererAgregation(t_agregation *ag) {
+    if (!ag) return;
+    free(ag->bloc_de);
+    free(ag->taille);
+    ag->bloc_de = NULL;
+    ag->taille = NULL;
+    ag->nb_blocs = 0;
+}
@@ -1,24 +1,360 @@
 #include "graph.h"
 #include "hasse.h"
 #include "matrix.h"
+#include "sparse.h"
+#include "classes.h"
+#include "cache.h"
+#include "spectral.h"
+#include "server.h"
+#include "outofcore.h"
+#include "compact.h"
+#include "batch.h"
+#include "precision.h"
+#include "estimation.h"
+#include "lump.h"
+#include "lookup.h"
+#include "shard.h"
+#include "ecriture.h"
+#include "recompense.h"
+#include "ingest.h"
+#include "spmv.h"
+#include "incremental.h"
+#include "reorder.h"
 #include "locale.h"
 #include <windows.h>
 
 /*point d'entrée du programme et flux principal d'exécution */
-int main() {
+int main(int argc, char **argv) {
     // pour la syntaxe UTF-8 sous Windows
     setlocale(LC_ALL, "fr_FR.UTF-8");
     SetConsoleOutputCP(CP_UTF8);
 
+    /* précision des itérations : markov.exe --precision simple|double|mixte [mode ...] */
+    t_precision precision = PRECISION_DEFAUT;
+    if (argc >= 3 && strcmp(argv[1], "--precision") == 0) {
+        if (precisionDepuisNom(argv[2], &precision) != 0) {
+            fprintf(stderr, "Précision inconnue '%s' (simple, double ou mixte)\n", argv[2]);
+            return 1;
+        }
+        argv += 2;
+        argc -= 2;
+    }
+    /* mode serveur : markov.exe --serveur <socket> [--workers N] [--donnees <dossier>] [fichiers...] */
+    if (argc >= 3 && strcmp(argv[1], "--serveur") == 0) {
+        int workers = SERVEUR_WORKERS_DEFAUT;
+        const char *dossier = SERVEUR_DOSSIER_DEFAUT;
+        int premier = 3;
+        while (premier + 1 < argc) {
+            if (strcmp(argv[premier], "--workers") == 0) workers = atoi(argv[premier + 1]);
+            else if (strcmp(argv[premier], "--donnees") == 0) dossier = argv[premier + 1];
+            else break;
+            premier += 2;
+        }
+        return lancerServeur(argv[2], workers, dossier, argv + premier, argc - premier) == 0 ? 0 : 1;
+    }
+    /* mode hors mémoire : markov.exe --hors-memoire <fichier texte ou binaire> [--compact] [--depart <etat>] */
+    if (argc >= 3 && strcmp(argv[1], "--hors-memoire") == 0) {
+        int compact = 0, depart = 0;
+        for (int a = 3; a < argc; a++) {
+            if (strcmp(argv[a], "--compact") == 0) compact = 1;
+            else if (strcmp(argv[a], "--depart") == 0 && a + 1 < argc) depart = atoi(argv[++a]);
+        }
+        int nv = nombreSommetsFichier(argv[2]);
+        if (nv <= 0) {
+            fprintf(stderr, "Impossible de lire '%s'\n", argv[2]);
+            return 1;
+        }
+        if (depart < 0 || depart > nv) {
+            fprintf(stderr, "Etat de depart hors intervalle (1..%d)\n", nv);
+            return 1;
+        }
+        float *pi = createZeroVector(nv);
+        if (depart > 0) pi[depart - 1] = 1.0f;  // limite depuis cet état
+        int it;
+        if (compact) {
+            /* dictionnaire exact, virgule fixe 16 bits au-delà de 65536 valeurs */
+            t_graphe_compact gc;
+            if (compresserFichier(argv[2], COMPACT_DICTIONNAIRE, BLOC_DEFAUT, &gc) != 0) {
+                fprintf(stderr, "Erreur de lecture de '%s'\n", argv[2]);
+                freeVector(pi);
+                return 1;
+            }
+            printf("Stockage compact : %lu octets (%ld aretes, %s)\n",
+                   (unsigned long)tailleGrapheCompact(&gc), gc.nnz,
+                   gc.mode == COMPACT_DICTIONNAIRE ? "dictionnaire" : "virgule fixe 16 bits");
+            it = stationnaireCompact(&gc, pi, 1e-6f, 100000);
+            libererGrapheCompact(&gc);
+        } else {
+            it = stationnaireHorsMemoire(argv[2], pi, 1e-6f, 100000, BLOC_DEFAUT);
+        }
+        if (it < 0) {
+            fprintf(stderr, "Erreur de lecture de '%s'\n", argv[2]);
+            freeVector(pi);
+            return 1;
+        }
+        if (depart > 0) printf("=== Distribution limite depuis l'etat %d (it=%d) ===\n", depart, it);
+        else printf("=== Distribution stationnaire hors mémoire (it=%d) ===\n", it);
+        for (int i = 0; i < nv; i++) {
+            printf("  Etat %d : %.8f\n", i + 1, pi[i]);
+        }
+        freeVector(pi);
+        return 0;
+    }
+    /* conversion : markov.exe --convertir <graphe.txt> <graphe.bin> */
+    if (argc >= 4 && strcmp(argv[1], "--convertir") == 0) {
+        long long nb = convertirTexteEnBinaire(argv[2], argv[3]);
+        if (nb < 0) {
+            fprintf(stderr, "Échec de la conversion de '%s' vers '%s'\n", argv[2], argv[3]);
+            return 1;
+        }
+        printf("%lld aretes ecrites dans '%s'\n", nb, argv[3]);
+        return 0;
+    }
+    /* mode réparti : markov.exe --shards <nombre de shards> <graphe> */
+    if (argc >= 4 && strcmp(argv[1], "--shards") == 0) {
+        liste_adjacence lg;
+        if (chargerGraphe(argv[3], &lg, NULL) != GRAPHE_OK) {
+            fprintf(stderr, "Impossible de lire '%s'\n", argv[3]);
+            return 1;
+        }
+        float *pi = createZeroVector(lg.taille);
+        int it = stationnaireShards(lg, pi, atoi(argv[2]), 1e-6f, 100000);
+        if (it < 0) {
+            fprintf(stderr, "Échec du calcul réparti\n");
+        } else {
+            printf("=== Distribution stationnaire répartie (it=%d) ===\n", it);
+            for (int i = 0; i < lg.taille; i++) {
+                printf("  Etat %d : %.8f\n", i + 1, pi[i]);
+            }
+        }
+        freeVector(pi);
+        free_liste_adjacence(&lg);
+        return it < 0 ? 1 : 0;
+    }
+    /* export : markov.exe --exporter <graphe> <mermaid|dot|csv|bin> <sortie> */
+    if (argc >= 5 && strcmp(argv[1], "--exporter") == 0) {
+        liste_adjacence lg;
+        if (chargerGraphe(argv[2], &lg, NULL) != GRAPHE_OK) {
+            fprintf(stderr, "Impossible de lire '%s'\n", argv[2]);
+            return 1;
+        }
+        int res;
+        if (strcmp(argv[3], "mermaid") == 0) {
+            res = ecrireMermaid(lg, argv[4]);
+        } else if (strcmp(argv[3], "dot") == 0) {
+            res = ecrireDot(lg, argv[4]);
+        } else if (strcmp(argv[3], "csv") == 0 || strcmp(argv[3], "bin") == 0) {
+            /* lignes reconstituées une à une depuis la liste : pas de matrice n x n */
+            res = argv[3][0] == 'c' ? ecrireGrapheCSV(lg, argv[4]) : ecrireGrapheBinaire(lg, argv[4]);
+        } else {
+            fprintf(stderr, "Format inconnu '%s' (mermaid, dot, csv ou bin)\n", argv[3]);
+            free_liste_adjacence(&lg);
+            return 1;
+        }
+        if (res != 0) fprintf(stderr, "Impossible d'écrire '%s'\n", argv[4]);
+        free_liste_adjacence(&lg);
+        return res == 0 ? 0 : 1;
+    }
+    /* récompenses : markov.exe --recompenses <graphe> <récompenses> [gamma ...] */
+    if (argc >= 4 && strcmp(argv[1], "--recompenses") == 0) {
+        liste_adjacence lg;
+        if (chargerGraphe(argv[2], &lg, NULL) != GRAPHE_OK) {
+            fprintf(stderr, "Impossible de lire '%s'\n", argv[2]);
+            return 1;
+        }
+        double *r;
+        int nb_r;
+        int lu = lireRecompenses(argv[3], lg.taille, &r, &nb_r);
+        if (lu != 0) {
+            fprintf(stderr, lu == -1 ? "Impossible de lire '%s'\n" : "Fichier de récompenses invalide '%s'\n", argv[3]);
+            free_liste_adjacence(&lg);
+            return 1;
+        }
+        int nb_f = argc > 4 ? argc - 4 : 1;
+        double *facteurs = (double*)malloc(nb_f * sizeof(double));
+        if (!facteurs) erreurFatale("alloc facteurs");
+        facteurs[0] = 0.9;
+        for (int f = 0; f < argc - 4; f++) facteurs[f] = atof(argv[4 + f]);
+        t_partition pg = tarjan(lg);
+        int *vtc = build_vertex_to_class_map(&pg, lg.taille);
+        t_link_array liens = create_links_from_partition(lg, &pg, vtc);
+        t_valeurs v;
+        int res = calculerValeurs(lg, &pg, vtc, &liens, r, nb_r, facteurs, nb_f,
+                                  VALEUR_GAUSS_SEIDEL, 1e-9, 100000, &v);
+        if (res != 0) {
+            fprintf(stderr, "Facteurs d'actualisation invalides (attendus dans [0, 1))\n");
+        } else {
+            printf("=== Valeurs actualisées (Gauss-Seidel, it=%d, résidu=%.2e) ===\n", v.iterations, v.residu);
+            for (int i = 0; i < lg.taille; i++) {
+                printf("  Etat %d :", i + 1);
+                for (int s = 0; s < v.nb_systemes; s++) {
+                    printf("  r%d/%.3g = %.6f", s / nb_f + 1, facteurs[s % nb_f], v.valeurs[(size_t)i * v.nb_systemes + s]);
+                }
+                printf("\n");
+            }
+            printf("=== Récompense moyenne à long terme ===\n");
+            for (int c = 0; c < pg.nb; c++) {
+                if (!v.persistante[c]) continue;
+                printf("  Classe %s (persistante) :", pg.classes[c].name);
+                for (int k = 0; k < nb_r; k++) {
+                    printf("  r%d = %.6f", k + 1, v.gain[(size_t)(pg.classes[c].members[0] - 1) * nb_r + k]);
+                }
+                printf("\n");
+            }
+            for (int i = 0; i < lg.taille; i++) {
+                if (v.persistante[vtc[i + 1] - 1]) continue;
+                printf("  Etat %d (transitoire) :", i + 1);
+                for (int k = 0; k < nb_r; k++) printf("  r%d = %.6f", k + 1, v.gain[(size_t)i * nb_r + k]);
+                printf("\n");
+            }
+            libererValeurs(&v);
+        }
+        free_link_array(&liens);
+        free(vtc);
+        free_partition(&pg);
+        free(facteurs);
+        free(r);
+        free_liste_adjacence(&lg);
+        return res == 0 ? 0 : 1;
+    }
+    /* validation : markov.exe --valider <graphe> [--renormaliser] [graphe nettoyé] */
+    if (argc >= 3 && strcmp(argv[1], "--valider") == 0) {
+        t_options_ingest opt;
+        optionsIngestParDefaut(&opt);
+        int suivant = 3;
+        if (argc > suivant && strcmp(argv[suivant], "--renormaliser") == 0) {
+            opt.renormaliser = 1;
+            suivant++;
+        }
+        liste_adjacence lg;
+        t_rapport_ingest r;
+        if (ingererGraphe(argv[2], &opt, &lg, &r) != GRAPHE_OK) {
+            fprintf(stderr, r.statut == GRAPHE_ERR_FICHIER ? "Impossible de lire '%s'\n"
+                                                           : "Nombre de sommets absent ou invalide dans '%s'\n", argv[2]);
+            return 1;
+        }
+        printf("=== Validation de %s ===\n", argv[2]);
+        afficherRapportIngest(&r);
+        if (opt.renormaliser) printf("  lignes renormalisées : %d\n", r.renormalisees);
+        printf(rapportValide(&r) ? "Le graphe est un graphe de Markov valide.\n"
+                                 : "Le graphe n'est pas un graphe de Markov.\n");
+        int res = 0;
+        if (argc > suivant) {
+            res = ecrireGrapheTexte(lg, argv[suivant]);
+            if (res != 0) fprintf(stderr, "Impossible d'écrire '%s'\n", argv[suivant]);
+        }
+        free_liste_adjacence(&lg);
+        return res == 0 ? 0 : 1;
+    }
+    /* estimation : markov.exe --estimer <journal de séquences> <graphe produit> */
+    if (argc >= 4 && strcmp(argv[1], "--estimer") == 0) {
+        t_estimation est;
+        if (estimerTransitions(argv[2], 0, &est) != 0) {
+            fprintf(stderr, "Impossible de lire '%s'\n", argv[2]);
+            return 1;
+        }
+        printf("%llu transitions observées, %d états, %ld transitions distinctes\n",
+               est.total, est.nb_etats, est.nb_comptages);
+        if (est.lignes_invalides > 0) {
+            fprintf(stderr, "Avertissement: %lld ligne(s) invalide(s)\n", est.lignes_invalides);
+        }
+        int res = ecrireGrapheEstime(&est, argv[3]);
+        if (res != 0) fprintf(stderr, "Impossible d'écrire '%s'\n", argv[3]);
+        libererEstimation(&est);
+        return res == 0 ? 0 : 1;
+    }
+    /* score de trajectoires : markov.exe --scorer <graphe> <trajectoires> */
+    if (argc >= 4 && strcmp(argv[1], "--scorer") == 0) {
+        liste_adjacence lg;
+        int *etats;
+        long *debut;
+        int nb;
+        if (chargerGraphe(argv[2], &lg, NULL) != GRAPHE_OK) {
+            fprintf(stderr, "Impossible de lire '%s'\n", argv[2]);
+            return 1;
+        }
+        if (lireTrajectoires(argv[3], &etats, &debut, &nb) != 0) {
+            fprintf(stderr, "Impossible de lire '%s'\n", argv[3]);
+            free_liste_adjacence(&lg);
+            return 1;
+        }
+        t_index_aretes idx = construireIndexAretes(lg);
+        t_score *scores = (t_score*)malloc((nb + 1) * sizeof(t_score));
+        if (!scores) erreurFatale("alloc scores");
+        int nw = nombreCoeurs() - 1;
+        t_ordonnanceur *o = creerOrdonnanceur(nw < 1 ? 1 : nw);
+        scorerTrajectoires(&idx, etats, debut, nb, scores, o);
+        detruireOrdonnanceur(o);
+        for (int r = 0; r < nb; r++) {
+            printf("%d : log-vraisemblance %.6f", r + 1, scores[r].log_vraisemblance);
+            if (scores[r].inconnues > 0) {
+                printf(" (%ld transition(s) inconnue(s), première au pas %ld)",
+                       scores[r].inconnues, scores[r].premiere_inconnue + 1);
+            }
+            printf("\n");
+        }
+        free(scores);
+        free(etats);
+        free(debut);
+        libererIndexAretes(&idx);
+        free_liste_adjacence(&lg);
+        return 0;
+    }
+    /* deltas : markov.exe --deltas <graphe> <fichier de deltas> */
+    if (argc >= 4 && strcmp(argv[1], "--deltas") == 0) {
+        liste_adjacence lg;
+        t_delta *deltas;
+        int nb, invalides;
+        if (chargerGraphe(argv[2], &lg, NULL) != GRAPHE_OK) {
+            fprintf(stderr, "Impossible de lire '%s'\n", argv[2]);
+            return 1;
+        }
+        if (lireDeltas(argv[3], &deltas, &nb, &invalides) != 0) {
+            fprintf(stderr, "Impossible de lire '%s'\n", argv[3]);
+            free_liste_adjacence(&lg);
+            return 1;
+        }
+        if (invalides > 0) fprintf(stderr, "Avertissement: %d ligne(s) de delta invalide(s)\n", invalides);
+        t_analyse a = creerAnalyse(lg, 1e-6f, 100000);
+        printf("=== Analyse initiale : %d classes (it=%d) ===\n", a.partition.nb, a.iterations);
+        int res = appliquerDeltas(&a, deltas, nb);
+        printf("=== %d delta(s) appliqué(s) : %s (it=%d) ===\n", nb,
+               res == DELTA_RECALCUL ? "classes recalculées" : "classes inchangées", a.iterations);
+        for (int c = 0; c < a.partition.nb; c++) {
+            printf("Composante %s: {", a.partition.classes[c].name);
+            for (int j = 0; j < a.partition.classes[c].size; j++) {
+                printf("%d%s", a.partition.classes[c].members[j], j + 1 < a.partition.classes[c].size ? "," : "");
+            }
+            printf("}\n");
+        }
+        for (int i = 0; i < lg.taille; i++) {
+            printf("  Etat %d : %.8f\n", i + 1, a.stationnaire[i]);
+        }
+        free(deltas);
+        libererAnalyse(&a);
+        return 0;
+    }
+    /* mode lot : markov.exe --lot <fichier de chaînes mises bout à bout> */
+    if (argc >= 3 && strcmp(argv[1], "--lot") == 0) {
+        if (analyserLot(argv[2], stdout, 1e-6f, 100000) < 0) {
+            fprintf(stderr, "Impossible de lire '%s'\n", argv[2]);
+            return 1;
+        }
+        return 0;
+    }
 
 
     // 1) Charger le graphe (Partie 1)
         /* Permettre à l'utilisateur de choisir un fichier dans le dossier data/
-           On vérifie l'existence du fichier avant d'appeler readGraph (qui exit() en cas d'erreur). */
+           On vérifie l'existence du fichier avant de le charger. */
         char filename[256];
         char path[512];
         FILE *f = NULL;
         liste_adjacence la;
+        t_options_ingest options;
+        optionsIngestParDefaut(&options);
+        options.trier = 0;   // ordre des arêtes de readGraph
+        t_rapport_ingest rapport;
         while (1) {
             printf("Entrez le nom du fichier dans le dossier data (ex: exemple_meteo.txt) : ");
             if (scanf("%255s", filename) != 1) {
@@ -32,20 +368,42 @@ int main() {
                 continue;
             } else {
                 fclose(f);
-                la = readGraph(path);
+                /* lecture validée en un passage : doublons fusionnés, sommes contrôlées */
+                if (ingererGraphe(path, &options, &la, &rapport) != GRAPHE_OK) {
+                    fprintf(stderr, "Nombre de sommets absent ou invalide dans '%s'\n", path);
+                    return 1;
+                }
                 break;
             }
         }
     printf("\n=== Affichage du graphe (liste d'adjacence) ===\n");
     afficherListeAdjacence(la);
     printf("\n=== Vérification du graphe ===\n");
-    verifierMarkov(la);
+    afficherRapportIngest(&rapport);
+    int markov_valide = rapportValide(&rapport);
+    printf(markov_valide ? "Le graphe est un graphe de Markov valide.\n"
+                         : "Le graphe n'est pas un graphe de Markov.\n");
     printf("\n=== Exportation vers Mermaid (graphe original) ===\n");
     exporterMermaid(la, "data/graphe_mermaid.mmd");
 
     // 2) Partie 2 : Tarjan pour trouver les classes
-    printf("\n=== Exécution de l'algorithme de Tarjan (composantes fortement connexes) ===\n");
-    t_partition partition = tarjan(la);
+    /* Le cache (dossier cache/) est indexé par l'empreinte de la liste d'arêtes :
+       si la même structure a déjà été analysée, partition, Hasse et périodes sont relus. */
+    int n = la.taille;
+    t_empreinte empreinte = calculerEmpreinte(la);
+    t_resultat_cache resultat;
+    int niveau_cache = chargerCache("cache", empreinte, n, &resultat);
+    if (niveau_cache != CACHE_ABSENT) {
+        printf("\n=== Classes relues depuis le cache (%s) ===\n",
+               niveau_cache == CACHE_COMPLET ? "chaîne identique" : "même topologie");
+    } else {
+        printf("\n=== Exécution de l'algorithme de Tarjan (composantes fortement connexes) ===\n");
+        resultat.n = n;
+        resultat.partition = tarjan(la);
+        resultat.periodes = NULL;
+        resultat.stationnaire = NULL;
+    }
+    t_partition partition = resultat.partition;
     for (int i = 0; i < partition.nb; i++) {
         printf("Composante %s: {", partition.classes[i].name);
         for (int j = 0; j < partition.classes[i].size; j++) {
@@ -55,11 +413,20 @@ int main() {
         printf("}\n");
     }
 
-    int n = la.taille;
     int *vertex_to_class = build_vertex_to_class_map(&partition, n);
+    /* sous-chaînes de toutes les classes (CSR, numérotation locale) en un parcours */
+    t_csr *sous_chaines = extraireSousChaines(la, &partition, vertex_to_class);
 
-    t_link_array hasse = create_links_from_partition(la, &partition, vertex_to_class);
-    removeTransitiveLinks(&hasse);
+    if (niveau_cache == CACHE_ABSENT) {
+        resultat.hasse = create_links_from_partition(la, &partition, vertex_to_class);
+        removeTransitiveLinks(&resultat.hasse);
+        resultat.periodes = (int*)malloc(partition.nb * sizeof(int));
+        if (!resultat.periodes) { perror("alloc periodes"); exit(EXIT_FAILURE); }
+        for (int i = 0; i < partition.nb; i++) {
+            resultat.periodes[i] = periodeCSR(&sous_chaines[i]);
+        }
+    }
+    t_link_array hasse = resultat.hasse;
 
     printf("\n=== Liens (classes) détectés ===\n");
     for (int i = 0; i < hasse.size; i++) {
@@ -70,6 +437,68 @@ int main() {
 
     compute_and_print_characteristics(&partition, &hasse);
 
+    /* le thread principal travaille aussi pendant les attentes : un worker de moins que de cœurs */
+    t_ordonnanceur *ordonnanceur = creerOrdonnanceur(nombreCoeurs() > 1 ? nombreCoeurs() - 1 : 1);
+
+    /* renumérotation pour la localité (classes en ordre topologique, RCM dans
+       chaque classe) : les itérations creuses tournent sur le graphe renuméroté
+       et les vecteurs sont remis dans l'ordre d'origine */
+    t_permutation permutation = calculerPermutation(la, &partition, &hasse, ORDRE_RCM);
+
+    /* Distribution stationnaire (itération creuse) : relue si la chaîne est identique,
+       sinon recalculée en partant du vecteur en cache (même topologie) ou de l'uniforme.
+       Si les sommes de lignes sont invalides, l'itération ne converge pas vers une
+       distribution (masse != 1) : la section est sautée. */
+    if (!markov_valide) {
+        printf("\n=== Distribution stationnaire ===\n");
+        printf("⚠️  Non calculée : le graphe n'est pas un graphe de Markov (sommes de lignes invalides)\n");
+        freeVector(resultat.stationnaire);
+        resultat.stationnaire = NULL;
+        if (niveau_cache != CACHE_COMPLET && sauverCache("cache", empreinte, &resultat) != 0) {
+            fprintf(stderr, "Avertissement: impossible d'écrire le cache\n");
+        }
+    } else if (niveau_cache != CACHE_COMPLET || !resultat.stationnaire) {
+        int it;
+        if (!resultat.stationnaire) {
+            resultat.stationnaire = createZeroVector(n);
+            for (int i = 0; i < n; i++) resultat.stationnaire[i] = 1.0f / n;
+        }
+        /* Agrégation exacte : les états indiscernables (même masse vers chaque
+           bloc) sont regroupés et la distribution stationnaire est calculée sur
+           le quotient. Elle ne sert qu'ici, quand rien n'est relu du cache : une
+           même topologie repart déjà du vecteur en cache. */
+        t_agregation agregation = {0};
+        if (niveau_cache == CACHE_ABSENT) {
+            agregation = calculerAgregation(la, NULL, LUMP_STRICT, 1e-6f);
+            printf("\n=== Agrégation exacte : %d états -> %d blocs ===\n", la.taille, agregation.nb_blocs);
+        }
+        if (niveau_cache == CACHE_ABSENT && agregation.nb_blocs < n) {
+            it = stationnaireParAgregation(la, &agregation, resultat.stationnaire, 1e-6f, 100000,
+                                           precision);
+        } else {
+            /* produit tiré sur la transposée du graphe renuméroté, réparti entre les workers */
+            liste_adjacence lp = permuterGraphe(la, &permutation);
+            t_spmv produit = creerSpmvAdjacence(lp, ordonnanceur);
+            free_liste_adjacence(&lp);
+            float *pp = createZeroVector(n);
+            vecteurVersPermute(&permutation, resultat.stationnaire, pp);
+            it = puissanceSpmv(&produit, pp, 1e-6f, 100000, precision);
+            vecteurVersOriginal(&permutation, pp, resultat.stationnaire);
+            freeVector(pp);
+            libererSpmv(&produit);
+        }
+        libererAgregation(&agregation);
+        printf("\n=== Distribution stationnaire (it=%d) ===\n", it);
+        if (sauverCache("cache", empreinte, &resultat) != 0) {
+            fprintf(stderr, "Avertissement: impossible d'écrire le cache\n");
+        }
+    } else {
+        printf("\n=== Distribution stationnaire (cache) ===\n");
+    }
+    for (int i = 0; markov_valide && i < n; i++) {
+        printf("  Etat %d : %.8f\n", i + 1, resultat.stationnaire[i]);
+    }
+
     // Partie 3: Calculs matriciels
     t_matrix matrix = createMatrixFromAdjacency(la);
     printf("\n=== Matrice d'adjacence ===\n");
@@ -96,6 +525,24 @@ int main() {
     printf("\n=== M^7 ===\n");
     printMatrix(m7);
 
+    /* Estimation spectrale par classe : donne à l'avance le nombre d'itérations
+       attendu pour M^n et pour les limites par classe (arrêt anticipé si pas de convergence). */
+    float eps_local = 1e-6f;
+    t_spectre *spectres = (t_spectre*)malloc(partition.nb * sizeof(t_spectre));
+    if (!spectres) { perror("alloc spectres"); exit(EXIT_FAILURE); }
+    printf("\n=== Estimation spectrale (par classe) ===\n");
+    estimerSpectres(ordonnanceur, la, &partition, vertex_to_class, eps_local, spectres);
+    for (int i = 0; i < partition.nb; i++) {
+        printf("%s (%s) : lambda = %.4f", partition.classes[i].name,
+               spectres[i].fermee ? "fermée, SLEM" : "transitoire, rayon spectral", spectres[i].lambda);
+        if (spectres[i].iterations_estimees < 0) {
+            printf(", pas de convergence attendue (période %d)\n", resultat.periodes[i]);
+        } else {
+            printf(", temps de mélange ~ %.1f, itérations estimées ~ %d\n",
+                   spectres[i].temps_melange, spectres[i].iterations_estimees);
+        }
+    }
+
     // convergence de M^n
     float epsilon = 0.01f;
     t_matrix prev = createEmptyMatrix(matrix.rows);
@@ -103,91 +550,51 @@ int main() {
     copyMatrix(current, matrix);
     int power = 1;
     int max_iter = 10000; /* protection contre boucle infinie */
-    while (power < max_iter) {
+    /* une classe fermée sans trou spectral (lambda ~ 1) et de période > 1 fait
+       osciller M^n indéfiniment : l'estimation, confirmée par la période
+       exacte, évite les max_iter produits denses */
+    int oscillante = -1;
+    for (int i = 0; i < partition.nb && oscillante < 0; i++) {
+        if (spectres[i].fermee && spectres[i].iterations_estimees < 0 && resultat.periodes[i] > 1) oscillante = i;
+    }
+    int converge = 0;
+    while (oscillante < 0 && power < max_iter) {
         copyMatrix(prev, current);
         multiplyMatrices(prev, matrix, current);
         power++;
         if (diffMatrices(prev, current) < epsilon) {
+            converge = 1;
             break;
         }
     }
-    if (power >= max_iter) {
+    if (oscillante >= 0) {
+        printf("⚠️  Avertissement : M^n ne converge pas (classe fermée %s de période %d)\n",
+               partition.classes[oscillante].name, resultat.periodes[oscillante]);
+    } else if (!converge) {
         printf("⚠️  Avertissement : convergence non atteinte après %d itérations\n", max_iter);
     }
-    printf("\n=== M^%d (convergence) ===\n", power);
-    printMatrix(current);
+    if (oscillante < 0) {
+        printf("\n=== M^%d (convergence) ===\n", power);
+        printMatrix(current);
+    }
 
-    // Calcul des sous-matrices et périodes
+    // Calcul des sous-matrices et périodes (classes analysées en parallèle, affichées dans l'ordre)
+    t_contexte_classes ctx_classes;
+    ctx_classes.partition = &partition;
+    ctx_classes.hasse = &hasse;
+    ctx_classes.sous_chaines = sous_chaines;
+    ctx_classes.periodes = resultat.periodes;
+    ctx_classes.spectres = spectres;
+    ctx_classes.epsilon = eps_local;
+    ctx_classes.precision = precision;
+    ctx_classes.permutation = &permutation;
+    t_sortie *sorties = analyserClasses(ordonnanceur, &ctx_classes);
     for (int i = 0; i < partition.nb; i++) {
-        t_matrix submatrix = subMatrix(matrix, partition, i);
-        printf("\n=== Sous-matrice pour la classe %s ===\n", partition.classes[i].name);
-        printMatrix(submatrix);
-        int period = getPeriod(submatrix);
-        printf("Période de la classe %s: %d\n", partition.classes[i].name, period);
-
-        /* Afficher sommes des lignes de la sous-matrice (vérifier stochastique ou non) */
-        printf("Sommes des lignes de la sous-matrice (par état dans la classe) :\n");
-        for (int r = 0; r < submatrix.rows; r++) {
-            float s = 0.0f;
-            for (int c = 0; c < submatrix.cols; c++) {
-                s += submatrix.data[r][c];
-            }
-            char status[64];
-            if (s > 0.999f && s < 1.001f) {
-                strcpy(status, "(stochastique)");
-            } else if (s < 0.999f) {
-                strcpy(status, "(sous-stochastique: masse sortante possible)");
-            } else {
-                strcpy(status, "(>1 erreur?)");
-            }
-            printf("  Etat %d (dans classe) : somme = %.6f %s\n",
-                   partition.classes[i].members[r], s, status);
-        }
-
-        /* Calculer la limite p0 * S^k pour p0 uniforme sur la classe (même pour classes transitoires) */
-        
-        int m = submatrix.rows;
-        if (m > 0) {
-            float *pcur = createZeroVector(m);
-            float *pnext = createZeroVector(m);
-            for (int t = 0; t < m; t++) {
-                pcur[t] = 1.0f / m; /* uniforme */
-            }
-            int it = 0;
-            int max_it_local = 100000;
-            float eps_local = 1e-6f;
-            while (it < max_it_local) {
-                multiplyVectorMatrix(pcur, submatrix, pnext);
-                float d = diffVectors(pcur, pnext, m);
-                copyVector(pcur, pnext, m);
-                if (d < eps_local) {
-                    break;
-                }
-                it++;
-            }
-            float mass = 0.0f;
-            for (int t = 0; t < m; t++) {
-                mass += pcur[t];
-            }
-            // stochastique signifie que la somme des composantes doit être 1(prochement), ce qui permet de savoir si la classe est fermée ou non
-            printf("Limite (approx) pour p0 uniforme sur la classe (it=%d) : somme des composantes = %.8f\n", it, mass);
-            for (int t = 0; t < m; t++) {
-                printf("  Etat %d : %.8f\n", partition.classes[i].members[t], pcur[t]);
-            }
-            freeVector(pcur);
-            freeVector(pnext);
-        }
-        /* Déterminer si la classe est persistante (pas de flèches sortantes dans le Hasse réduit) */
-        if(compute_caracteristics(&partition, &hasse, i+1) == 0) {
-            printf("-> La classe %s est persistante.\n", partition.classes[i].name);
-        } else {
-            printf("-> La classe %s est transitoire.\n", partition.classes[i].name);
-        }
-
-        /* libération de la sous-matrice */
-        for (int rr = 0; rr < submatrix.rows; rr++) free(submatrix.data[rr]);
-        free(submatrix.data);
+        fwrite(sorties[i].texte, 1, sorties[i].len, stdout);
     }
+    libererSorties(sorties, partition.nb);
+    detruireOrdonnanceur(ordonnanceur);
+    libererPermutation(&permutation);
 
     /* libérer matrices temporaires utilisées plus haut */
     for (int i = 0; i < m3.rows; i++) {
@@ -226,9 +633,10 @@ int main() {
     free(current.data);
 
     // Cleanup
+    free(spectres);
+    libererSousChaines(sous_chaines, partition.nb);
     free(vertex_to_class);
-    free_link_array(&hasse);
-    free_partition(&partition);
+    libererResultatCache(&resultat);
     free_liste_adjacence(&la);
     for (int i = 0; i < matrix.rows; i++) {
         free(matrix.data[i]);
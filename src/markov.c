@@ -0,0 +1,301 @@
+#include "markov.h"
+#include "graph.h"
+#include "hasse.h"
+#include "matrix.h"
+#include "reach.h"
+#include "precision.h"
+#include "spmv.h"
+
+struct markov_ctx {
+    liste_adjacence la;
+    int charge;               // 1 si une chaîne est chargée
+    t_spmv produit;           // transposée de la chaîne chargée (produit tiré)
+    t_ordonnanceur *ordonnanceur;  // workers du contexte (NULL tant qu'aucune grosse chaîne)
+    int analyse;              // 1 si markov_analyser a réussi depuis le dernier chargement
+    t_partition partition;
+    int *vertex_to_class;
+    t_link_array hasse;
+    int *persistante;         // persistante[c] (1-based)
+    int *periodes;            // periodes[c] (1-based)
+    float *stationnaire;
+    t_reachability reach;
+};
+
+/* Protection des points d'entrée : une erreur fatale (allocation) dans le
+   code appelé revient ici au lieu de quitter le programme. Les résultats
+   partiels (listes, CSR, fichiers, tampons d'écriture) sont suivis dans un
+   registre propre à l'appel (suivreRessource) et libérés par erreurFatale :
+   les requêtes d'un même contexte peuvent tourner en parallèle, le registre
+   ne peut donc pas vivre dans le contexte lui-même. */
+#define MARKOV_DEBUT_PROTEGE()                                   \
+    jmp_buf reprise;                                             \
+    t_ressources ressources;                                     \
+    jmp_buf *ancien_point = definirPointReprise(&reprise);       \
+    t_ressources *anciennes = definirRessources(&ressources);    \
+    if (setjmp(reprise)) {                                       \
+        definirRessources(anciennes);                            \
+        definirPointReprise(ancien_point);                       \
+        return MARKOV_ERR_MEMOIRE;                               \
+    }
+#define MARKOV_FIN_PROTEGE()                                     \
+    do {                                                         \
+        definirRessources(anciennes);                            \
+        definirPointReprise(ancien_point);                       \
+    } while (0)
+
+static void libererAnalyseCtx(markov_ctx *ctx) {
+    if (!ctx->analyse) return;
+    free_partition(&ctx->partition);
+    free(ctx->vertex_to_class);
+    free_link_array(&ctx->hasse);
+    free(ctx->persistante);
+    free(ctx->periodes);
+    freeVector(ctx->stationnaire);
+    free_reachability_index(&ctx->reach);
+    ctx->vertex_to_class = NULL;
+    ctx->persistante = ctx->periodes = NULL;
+    ctx->stationnaire = NULL;
+    ctx->analyse = 0;
+}
+
+static void libererChaine(markov_ctx *ctx) {
+    libererAnalyseCtx(ctx);
+    if (ctx->charge) {
+        free_liste_adjacence(&ctx->la);
+        libererSpmv(&ctx->produit);
+    }
+    ctx->charge = 0;
+}
+
+/* workers créés au premier chargement d'une chaîne assez grosse pour le produit parallèle */
+static t_ordonnanceur *ordonnanceurPour(markov_ctx *ctx, liste_adjacence la) {
+    if (ctx->ordonnanceur || nombreCoeurs() < 2) return ctx->ordonnanceur;
+    long nnz = 0;
+    for (int i = 0; i < la.taille; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) nnz++;
+    }
+    if (nnz >= SPMV_SEUIL_PARALLELE) ctx->ordonnanceur = creerOrdonnanceur(nombreCoeurs() - 1);
+    return ctx->ordonnanceur;
+}
+
+markov_statut markov_creer(markov_ctx **ctx) {
+    if (!ctx) return MARKOV_ERR_ARGUMENT;
+    *ctx = (markov_ctx*)calloc(1, sizeof(markov_ctx));
+    return *ctx ? MARKOV_OK : MARKOV_ERR_MEMOIRE;
+}
+
+void markov_detruire(markov_ctx *ctx) {
+    if (!ctx) return;
+    libererChaine(ctx);
+    detruireOrdonnanceur(ctx->ordonnanceur);
+    free(ctx);
+}
+
+const char *markov_message(markov_statut s) {
+    switch (s) {
+    case MARKOV_OK:           return "succès";
+    case MARKOV_ERR_ARGUMENT: return "paramètre invalide";
+    case MARKOV_ERR_FICHIER:  return "fichier inaccessible";
+    case MARKOV_ERR_FORMAT:   return "format de fichier invalide";
+    case MARKOV_ERR_MEMOIRE:  return "mémoire insuffisante";
+    case MARKOV_ERR_ETAT:     return "opération invalide dans l'état courant";
+    }
+    return "erreur inconnue";
+}
+
+markov_statut markov_charger_fichier(markov_ctx *ctx, const char *chemin) {
+    if (!ctx || !chemin) return MARKOV_ERR_ARGUMENT;
+    MARKOV_DEBUT_PROTEGE();
+    liste_adjacence la;
+    t_spmv produit;
+    int res = chargerGraphe(chemin, &la, NULL);
+    if (res == GRAPHE_OK) {
+        suivreRessource(&la, ressourceListe);
+        produit = creerSpmvAdjacence(la, ordonnanceurPour(ctx, la));
+    }
+    MARKOV_FIN_PROTEGE();
+    if (res == GRAPHE_ERR_FICHIER) return MARKOV_ERR_FICHIER;
+    if (res == GRAPHE_ERR_FORMAT) return MARKOV_ERR_FORMAT;
+    libererChaine(ctx);
+    ctx->la = la;
+    ctx->produit = produit;
+    ctx->charge = 1;
+    return MARKOV_OK;
+}
+
+markov_statut markov_charger_aretes(markov_ctx *ctx, int n, const int *depart, const int *arrivee,
+                                    const float *proba, int nb_aretes) {
+    if (!ctx || n <= 0 || nb_aretes < 0 || (nb_aretes > 0 && (!depart || !arrivee || !proba))) {
+        return MARKOV_ERR_ARGUMENT;
+    }
+    for (int k = 0; k < nb_aretes; k++) {
+        if (depart[k] < 1 || depart[k] > n || arrivee[k] < 1 || arrivee[k] > n) return MARKOV_ERR_ARGUMENT;
+    }
+    MARKOV_DEBUT_PROTEGE();
+    liste_adjacence la = creerListeAdjacence(n);
+    suivreRessource(&la, ressourceListe);
+    for (int k = nb_aretes - 1; k >= 0; k--) {
+        ajouterCellule(&la.tab[depart[k] - 1], arrivee[k], proba[k]);
+    }
+    t_spmv produit = creerSpmvAdjacence(la, ordonnanceurPour(ctx, la));
+    MARKOV_FIN_PROTEGE();
+    libererChaine(ctx);
+    ctx->la = la;
+    ctx->produit = produit;
+    ctx->charge = 1;
+    return MARKOV_OK;
+}
+
+markov_statut markov_analyser(markov_ctx *ctx, float epsilon, int max_iter) {
+    if (!ctx || epsilon <= 0.0f || max_iter <= 0) return MARKOV_ERR_ARGUMENT;
+    if (!ctx->charge) return MARKOV_ERR_ETAT;
+    libererAnalyseCtx(ctx);
+    MARKOV_DEBUT_PROTEGE();
+    int n = ctx->la.taille;
+    t_partition partition = tarjan(ctx->la);
+    suivreRessource(&partition, ressourcePartition);
+    int *vtc = build_vertex_to_class_map(&partition, n);
+    suivreRessource(vtc, free);
+    t_link_array liens = create_links_from_partition(ctx->la, &partition, vtc);
+    suivreRessource(&liens, ressourceLiens);
+    t_reachability reach = build_reachability_index(&partition, &liens, vtc, n);
+    suivreRessource(&reach, ressourceReach);
+    int *persistante = (int*)calloc(partition.nb + 1, sizeof(int));
+    int *periodes = (int*)calloc(partition.nb + 1, sizeof(int));
+    suivreRessource(persistante, free);
+    suivreRessource(periodes, free);
+    if (!persistante || !periodes) erreurFatale("alloc markov_analyser");
+    for (int c = 1; c <= partition.nb; c++) persistante[c] = 1;
+    for (int k = 0; k < liens.size; k++) persistante[liens.links[k].from] = 0;
+    for (int c = 0; c < partition.nb; c++) {
+        periodes[c + 1] = getPeriodAdjacency(ctx->la, &partition, vtc, c);
+    }
+    removeTransitiveLinks(&liens);
+    float *pi = createZeroVector(n);
+    suivreRessource(pi, free);
+    for (int i = 0; i < n; i++) pi[i] = 1.0f / n;
+    puissanceSpmv(&ctx->produit, pi, epsilon, max_iter, PRECISION_SIMPLE);
+    MARKOV_FIN_PROTEGE();
+
+    ctx->partition = partition;
+    ctx->vertex_to_class = vtc;
+    ctx->hasse = liens;
+    ctx->reach = reach;
+    ctx->persistante = persistante;
+    ctx->periodes = periodes;
+    ctx->stationnaire = pi;
+    ctx->analyse = 1;
+    return MARKOV_OK;
+}
+
+int markov_nb_etats(const markov_ctx *ctx) {
+    return (ctx && ctx->charge) ? ctx->la.taille : 0;
+}
+
+int markov_nb_classes(const markov_ctx *ctx) {
+    return (ctx && ctx->analyse) ? ctx->partition.nb : 0;
+}
+
+/* vérifie le contexte et l'intervalle d'un état (1..n) */
+static markov_statut verifierEtat(const markov_ctx *ctx, int etat) {
+    if (!ctx) return MARKOV_ERR_ARGUMENT;
+    if (!ctx->analyse) return MARKOV_ERR_ETAT;
+    if (etat < 1 || etat > ctx->la.taille) return MARKOV_ERR_ARGUMENT;
+    return MARKOV_OK;
+}
+
+static markov_statut verifierClasse(const markov_ctx *ctx, int classe) {
+    if (!ctx) return MARKOV_ERR_ARGUMENT;
+    if (!ctx->analyse) return MARKOV_ERR_ETAT;
+    if (classe < 1 || classe > ctx->partition.nb) return MARKOV_ERR_ARGUMENT;
+    return MARKOV_OK;
+}
+
+markov_statut markov_classe_de(const markov_ctx *ctx, int etat, int *classe) {
+    markov_statut s = verifierEtat(ctx, etat);
+    if (s != MARKOV_OK) return s;
+    if (!classe) return MARKOV_ERR_ARGUMENT;
+    *classe = ctx->vertex_to_class[etat];
+    return MARKOV_OK;
+}
+
+markov_statut markov_membres_classe(const markov_ctx *ctx, int classe, const int **membres, int *taille) {
+    markov_statut s = verifierClasse(ctx, classe);
+    if (s != MARKOV_OK) return s;
+    if (!membres || !taille) return MARKOV_ERR_ARGUMENT;
+    *membres = ctx->partition.classes[classe - 1].members;
+    *taille = ctx->partition.classes[classe - 1].size;
+    return MARKOV_OK;
+}
+
+markov_statut markov_classe_persistante(const markov_ctx *ctx, int classe, int *persistante) {
+    markov_statut s = verifierClasse(ctx, classe);
+    if (s != MARKOV_OK) return s;
+    if (!persistante) return MARKOV_ERR_ARGUMENT;
+    *persistante = ctx->persistante[classe];
+    return MARKOV_OK;
+}
+
+markov_statut markov_periode(const markov_ctx *ctx, int classe, int *periode) {
+    markov_statut s = verifierClasse(ctx, classe);
+    if (s != MARKOV_OK) return s;
+    if (!periode) return MARKOV_ERR_ARGUMENT;
+    *periode = ctx->periodes[classe];
+    return MARKOV_OK;
+}
+
+markov_statut markov_stationnaire(const markov_ctx *ctx, int etat, float *proba) {
+    markov_statut s = verifierEtat(ctx, etat);
+    if (s != MARKOV_OK) return s;
+    if (!proba) return MARKOV_ERR_ARGUMENT;
+    *proba = ctx->stationnaire[etat - 1];
+    return MARKOV_OK;
+}
+
+/* out = p0 * P^k (vecteurs de taille n, out peut être égal à p0) */
+markov_statut markov_distribution_k(const markov_ctx *ctx, const float *p0, int k, float *out) {
+    if (!ctx || !p0 || !out || k < 0) return MARKOV_ERR_ARGUMENT;
+    if (!ctx->charge) return MARKOV_ERR_ETAT;
+    int n = ctx->la.taille;
+    MARKOV_DEBUT_PROTEGE();
+    float *cur = createZeroVector(n);
+    suivreRessource(cur, free);
+    memcpy(cur, p0, n * sizeof(float));
+    etapesSpmv(&ctx->produit, cur, k);
+    MARKOV_FIN_PROTEGE();
+    memcpy(out, cur, n * sizeof(float));
+    freeVector(cur);
+    return MARKOV_OK;
+}
+
+markov_statut markov_atteignable(const markov_ctx *ctx, int i, int j, int *resultat) {
+    markov_statut s = verifierEtat(ctx, i);
+    if (s != MARKOV_OK) return s;
+    s = verifierEtat(ctx, j);
+    if (s != MARKOV_OK) return s;
+    if (!resultat) return MARKOV_ERR_ARGUMENT;
+    MARKOV_DEBUT_PROTEGE();
+    *resultat = can_reach((t_reachability*)&ctx->reach, i, j);
+    MARKOV_FIN_PROTEGE();
+    return MARKOV_OK;
+}
+
+markov_statut markov_exporter_mermaid(const markov_ctx *ctx, const char *graphe, const char *hasse) {
+    if (!ctx) return MARKOV_ERR_ARGUMENT;
+    if (!ctx->charge || (hasse && !ctx->analyse)) return MARKOV_ERR_ETAT;
+    MARKOV_DEBUT_PROTEGE();
+    int ok = (!graphe || ecrireMermaid(ctx->la, graphe) == 0) &&
+             (!hasse || ecrireMermaidHasse((t_partition*)&ctx->partition, (t_link_array*)&ctx->hasse, hasse) == 0);
+    MARKOV_FIN_PROTEGE();
+    return ok ? MARKOV_OK : MARKOV_ERR_FICHIER;
+}
+
+markov_statut markov_exporter_dot(const markov_ctx *ctx, const char *graphe, const char *hasse) {
+    if (!ctx) return MARKOV_ERR_ARGUMENT;
+    if (!ctx->charge || (hasse && !ctx->analyse)) return MARKOV_ERR_ETAT;
+    MARKOV_DEBUT_PROTEGE();
+    int ok = (!graphe || ecrireDot(ctx->la, graphe) == 0) &&
+             (!hasse || ecrireDotHasse((t_partition*)&ctx->partition, (t_link_array*)&ctx->hasse, hasse) == 0);
+    MARKOV_FIN_PROTEGE();
+    return ok ? MARKOV_OK : MARKOV_ERR_FICHIER;
+}
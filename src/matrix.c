@@ -1,4 +1,5 @@
 #include "matrix.h"
+#include "ecriture.h"
 #include <math.h>
 
 #include <stdlib.h>
@@ -10,7 +11,8 @@ t_matrix createMatrixFromAdjacency(liste_adjacence la) {
     for (int i = 0; i < la.taille; i++) {
         cellule* tmp = la.tab[i].head;
         while (tmp) {
-            matrix.data[i][tmp->arrivee - 1] = tmp->proba;
+            /* arêtes en double additionnées, comme dans les produits creux */
+            matrix.data[i][tmp->arrivee - 1] += tmp->proba;
             tmp = tmp->suivant;
         }
     }
@@ -20,12 +22,16 @@ t_matrix createMatrixFromAdjacency(liste_adjacence la) {
 
 /* affiche une matrice sur la sortie standard */
 void printMatrix(t_matrix matrix) {
+    t_ecrivain e;
+    initEcrivain(&e, stdout);
     for (int i = 0; i < matrix.rows; i++) {
         for (int j = 0; j < matrix.cols; j++) {
-            printf("%.2f ", matrix.data[i][j]);
+            ecrireFlottant(&e, matrix.data[i][j], 2);
+            ecrireCaractere(&e, ' ');
         }
-        printf("\n");
+        ecrireCaractere(&e, '\n');
     }
+    fermerEcrivain(&e);
 }
 
 /*alloue et initialise une matrice carrée vide de taille 'size' */
@@ -34,8 +40,10 @@ t_matrix createEmptyMatrix(int size) {
     matrix.rows = size;
     matrix.cols = size;
     matrix.data = (float**)malloc(size * sizeof(float*));
+    if (!matrix.data) { erreurFatale("alloc matrice"); }
     for (int i = 0; i < size; i++) {
         matrix.data[i] = (float*)calloc(size, sizeof(float));
+        if (!matrix.data[i]) { erreurFatale("alloc matrice"); }
     }
     return matrix;
 }
@@ -158,6 +166,50 @@ int getPeriod(t_matrix sub_matrix) {
     return period;
 }
 
+/* getPeriodAdjacency
+ Période d'une classe calculée directement sur la liste d'adjacence, sans
+ matrice dense : un parcours en largeur depuis le premier membre donne un
+ niveau à chaque sommet de la classe ; la période est le PGCD des
+ niveau[u] + 1 - niveau[v] sur toutes les arêtes u -> v internes à la classe.
+ Coût O(arêtes de la classe) au lieu de O(size^4).
+ */
+int getPeriodAdjacency(liste_adjacence la, t_partition *part, int *vertex_to_class, int compo_index) {
+    t_classe *c = &part->classes[compo_index];
+    int ci = compo_index + 1;
+    int *niveau = (int *)malloc((la.taille + 1) * sizeof(int));
+    int *file = (int *)malloc(c->size * sizeof(int));
+    if (!niveau || !file) {
+        free(niveau);
+        free(file);
+        erreurFatale("alloc getPeriodAdjacency");
+    }
+    for (int k = 0; k < c->size; k++) niveau[c->members[k]] = -1;
+
+    int debut = 0, fin = 0, period = 0;
+    niveau[c->members[0]] = 0;
+    file[fin++] = c->members[0];
+    while (debut < fin) {
+        int u = file[debut++];
+        cellule *tmp = la.tab[u - 1].head;
+        while (tmp) {
+            int v = tmp->arrivee;
+            if (tmp->proba > 0.0f && vertex_to_class[v] == ci) {
+                if (niveau[v] == -1) {
+                    niveau[v] = niveau[u] + 1;
+                    file[fin++] = v;
+                } else {
+                    int vals[2] = { period, abs(niveau[u] + 1 - niveau[v]) };
+                    period = gcd(vals, 2);
+                }
+            }
+            tmp = tmp->suivant;
+        }
+    }
+    free(niveau);
+    free(file);
+    return period;
+}
+
 /*
    Vecteurs / distributions
 */
@@ -165,6 +217,7 @@ int getPeriod(t_matrix sub_matrix) {
 /*alloue et initialise un vecteur de taille n à zéro */
 float *createZeroVector(int n) {
     float *v = (float*)calloc(n, sizeof(float));
+    if (!v && n > 0) { erreurFatale("alloc vecteur"); }
     return v;
 }
 
@@ -225,3 +278,40 @@ float *computeStationaryDistribution(t_matrix mat, float epsilon, int max_iter)
     freeVector(tmp);
     return p; /* le code appelant doit libérer */
 }
+
+
+/*calcule out = vec * P en parcourant directement la liste d'adjacence */
+void multiplyVectorAdjacency(float *vec, liste_adjacence la, float *out) {
+    for (int j = 0; j < la.taille; j++) {
+        out[j] = 0.0f;
+    }
+    for (int i = 0; i < la.taille; i++) {
+        float vi = vec[i];
+        if (vi == 0.0f) continue;
+        cellule *tmp = la.tab[i].head;
+        while (tmp) {
+            out[tmp->arrivee - 1] += vi * tmp->proba;
+            tmp = tmp->suivant;
+        }
+    }
+}
+
+/* computeStationaryDistributionFrom
+ Itération de puissance creuse démarrant du vecteur p fourni (démarrage à chaud,
+ par ex. la distribution obtenue avant une petite modification du graphe).
+ Le résultat est écrit dans p. Renvoie le nombre d'itérations effectuées.
+ */
+int computeStationaryDistributionFrom(liste_adjacence la, float *p, float epsilon, int max_iter) {
+    int n = la.taille;
+    float *tmp = createZeroVector(n);
+    int iter = 0;
+    while (iter < max_iter) {
+        multiplyVectorAdjacency(p, la, tmp);
+        float d = diffVectors(p, tmp, n);
+        copyVector(p, tmp, n);
+        iter++;
+        if (d < epsilon) break;
+    }
+    freeVector(tmp);
+    return iter;
+}
@@ -0,0 +1,226 @@
+#include "ordonnanceur.h"
+#include "graph.h"
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+typedef struct {
+    t_fonction_tache fn;
+    void *arg;
+    t_groupe *groupe;
+} t_tache;
+
+/* file double protégée par un verrou : le propriétaire travaille en fin, les voleurs en début */
+typedef struct {
+    t_tache *taches;
+    int debut, fin, cap;
+    pthread_mutex_t verrou;
+} t_deque;
+
+struct t_ordonnanceur {
+    int nb_workers;
+    pthread_t *threads;
+    t_deque *deques;              // nb_workers + 1 (la dernière pour les threads extérieurs)
+    atomic_int en_attente;        // tâches dans les files
+    atomic_int arret;
+    pthread_mutex_t verrou_sommeil;
+    pthread_cond_t reveil;
+};
+
+typedef struct {
+    t_ordonnanceur *o;
+    int id;
+} t_arg_worker;
+
+/* worker courant : ordonnanceur et indice de sa file */
+static _Thread_local t_ordonnanceur *ordonnanceur_courant = NULL;
+static _Thread_local int indice_courant = -1;
+
+static int monIndice(t_ordonnanceur *o) {
+    return ordonnanceur_courant == o ? indice_courant : o->nb_workers;
+}
+
+static void dequePousser(t_deque *d, t_tache t) {
+    pthread_mutex_lock(&d->verrou);
+    if (d->fin == d->cap) {
+        if (d->debut > 0) {
+            memmove(d->taches, d->taches + d->debut, (d->fin - d->debut) * sizeof(t_tache));
+            d->fin -= d->debut;
+            d->debut = 0;
+        } else {
+            int cap = d->cap * 2;
+            t_tache *n = (t_tache*)realloc(d->taches, cap * sizeof(t_tache));
+            if (!n) erreurFatale("alloc ordonnanceur");
+            d->taches = n;
+            d->cap = cap;
+        }
+    }
+    d->taches[d->fin++] = t;
+    pthread_mutex_unlock(&d->verrou);
+}
+
+/* retire une tâche : par la fin (propriétaire) ou par le début (vol) */
+static int dequeRetirer(t_deque *d, int vol, t_tache *t) {
+    int ok = 0;
+    pthread_mutex_lock(&d->verrou);
+    if (d->fin > d->debut) {
+        *t = vol ? d->taches[d->debut++] : d->taches[--d->fin];
+        if (d->debut == d->fin) d->debut = d->fin = 0;
+        ok = 1;
+    }
+    pthread_mutex_unlock(&d->verrou);
+    return ok;
+}
+
+/* sa propre file d'abord, puis vol dans les autres en partant du voisin */
+static int trouverTache(t_ordonnanceur *o, int id, t_tache *t) {
+    if (atomic_load(&o->en_attente) == 0) return 0;
+    if (dequeRetirer(&o->deques[id], 0, t)) {
+        atomic_fetch_sub(&o->en_attente, 1);
+        return 1;
+    }
+    int total = o->nb_workers + 1;
+    for (int k = 1; k < total; k++) {
+        if (dequeRetirer(&o->deques[(id + k) % total], 1, t)) {
+            atomic_fetch_sub(&o->en_attente, 1);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* la dernière tâche d'un groupe réveille ceux qui l'attendent */
+static void executer(t_ordonnanceur *o, t_tache *t) {
+    t->fn(t->arg);
+    if (atomic_fetch_sub(&t->groupe->restantes, 1) == 1) {
+        pthread_mutex_lock(&o->verrou_sommeil);
+        pthread_cond_broadcast(&o->reveil);
+        pthread_mutex_unlock(&o->verrou_sommeil);
+    }
+}
+
+static void *boucleWorker(void *arg) {
+    t_arg_worker *a = (t_arg_worker*)arg;
+    t_ordonnanceur *o = a->o;
+    ordonnanceur_courant = o;
+    indice_courant = a->id;
+    free(a);
+    t_tache t;
+    while (!atomic_load(&o->arret)) {
+        if (trouverTache(o, indice_courant, &t)) {
+            executer(o, &t);
+            continue;
+        }
+        pthread_mutex_lock(&o->verrou_sommeil);
+        while (atomic_load(&o->en_attente) == 0 && !atomic_load(&o->arret)) {
+            pthread_cond_wait(&o->reveil, &o->verrou_sommeil);
+        }
+        pthread_mutex_unlock(&o->verrou_sommeil);
+    }
+    return NULL;
+}
+
+/* crée nb_workers threads (nb_workers <= 0 : un par cœur) */
+t_ordonnanceur *creerOrdonnanceur(int nb_workers) {
+    if (nb_workers <= 0) nb_workers = nombreCoeurs();
+    t_ordonnanceur *o = (t_ordonnanceur*)calloc(1, sizeof(t_ordonnanceur));
+    if (!o) erreurFatale("alloc ordonnanceur");
+    o->nb_workers = nb_workers;
+    o->threads = (pthread_t*)malloc(nb_workers * sizeof(pthread_t));
+    o->deques = (t_deque*)calloc(nb_workers + 1, sizeof(t_deque));
+    if (!o->threads || !o->deques) erreurFatale("alloc ordonnanceur");
+    for (int i = 0; i <= nb_workers; i++) {
+        o->deques[i].cap = 64;
+        o->deques[i].taches = (t_tache*)malloc(o->deques[i].cap * sizeof(t_tache));
+        if (!o->deques[i].taches) erreurFatale("alloc ordonnanceur");
+        pthread_mutex_init(&o->deques[i].verrou, NULL);
+    }
+    atomic_init(&o->en_attente, 0);
+    atomic_init(&o->arret, 0);
+    pthread_mutex_init(&o->verrou_sommeil, NULL);
+    pthread_cond_init(&o->reveil, NULL);
+    for (int i = 0; i < nb_workers; i++) {
+        t_arg_worker *a = (t_arg_worker*)malloc(sizeof(t_arg_worker));
+        if (!a) erreurFatale("alloc ordonnanceur");
+        a->o = o;
+        a->id = i;
+        if (pthread_create(&o->threads[i], NULL, boucleWorker, a) != 0) {
+            erreurFatale("pthread_create");
+        }
+    }
+    return o;
+}
+
+void initGroupe(t_groupe *g) {
+    atomic_init(&g->restantes, 0);
+}
+
+/* ajoute une tâche dans la file du thread appelant et réveille un worker */
+void soumettreTache(t_ordonnanceur *o, t_groupe *g, t_fonction_tache fn, void *arg) {
+    t_tache t;
+    t.fn = fn;
+    t.arg = arg;
+    t.groupe = g;
+    atomic_fetch_add(&g->restantes, 1);
+    dequePousser(&o->deques[monIndice(o)], t);
+    atomic_fetch_add(&o->en_attente, 1);
+    pthread_mutex_lock(&o->verrou_sommeil);
+    pthread_cond_signal(&o->reveil);
+    pthread_mutex_unlock(&o->verrou_sommeil);
+}
+
+/* attend la fin du groupe en exécutant les tâches disponibles (les siennes ou
+ volées) ; sans tâche à prendre, dort jusqu'à une soumission ou la fin d'un groupe */
+void attendreGroupe(t_ordonnanceur *o, t_groupe *g) {
+    int id = monIndice(o);
+    t_tache t;
+    while (atomic_load(&g->restantes) > 0) {
+        if (trouverTache(o, id, &t)) {
+            executer(o, &t);
+            continue;
+        }
+        pthread_mutex_lock(&o->verrou_sommeil);
+        while (atomic_load(&g->restantes) > 0 && atomic_load(&o->en_attente) == 0) {
+            pthread_cond_wait(&o->reveil, &o->verrou_sommeil);
+        }
+        pthread_mutex_unlock(&o->verrou_sommeil);
+    }
+}
+
+int nombreWorkers(t_ordonnanceur *o) {
+    return o->nb_workers;
+}
+
+/* arrête et libère les workers (les groupes doivent être terminés) */
+void detruireOrdonnanceur(t_ordonnanceur *o) {
+    if (!o) return;
+    pthread_mutex_lock(&o->verrou_sommeil);
+    atomic_store(&o->arret, 1);
+    pthread_cond_broadcast(&o->reveil);
+    pthread_mutex_unlock(&o->verrou_sommeil);
+    for (int i = 0; i < o->nb_workers; i++) pthread_join(o->threads[i], NULL);
+    for (int i = 0; i <= o->nb_workers; i++) {
+        pthread_mutex_destroy(&o->deques[i].verrou);
+        free(o->deques[i].taches);
+    }
+    pthread_mutex_destroy(&o->verrou_sommeil);
+    pthread_cond_destroy(&o->reveil);
+    free(o->deques);
+    free(o->threads);
+    free(o);
+}
+
+int nombreCoeurs(void) {
+#ifdef _WIN32
+    SYSTEM_INFO si;
+    GetSystemInfo(&si);
+    return si.dwNumberOfProcessors > 0 ? (int)si.dwNumberOfProcessors : 1;
+#else
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+#endif
+}
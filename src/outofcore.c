@@ -0,0 +1,267 @@
+#include "outofcore.h"
+#include "graph.h"
+#include "matrix.h"
+#include <pthread.h>
+
+/* un bloc d'arêtes en cours de lecture ou de calcul */
+typedef struct {
+    t_arete_binaire *aretes;
+    long nb;      // nombre d'arêtes valides, 0 = fin du fichier
+    int plein;    // 1 : prêt pour le calcul, 0 : libre pour la lecture
+} t_bloc;
+
+/* état partagé entre le thread lecteur et le calcul */
+typedef struct {
+    t_fichier_aretes fa;
+    long taille_bloc;
+    int n;
+    t_bloc blocs[2];
+    int erreur;
+    int passes;   // passages demandés par le calcul
+    int arret;    // 1 : le lecteur doit se terminer
+    pthread_mutex_t verrou;
+    pthread_cond_t change;
+} t_flux;
+
+/* ouvre le fichier et lit l'en-tête (binaire ou texte) ; renvoie 0 ou -1 */
+int ouvrirFichierAretes(t_fichier_aretes *fa, const char *chemin) {
+    fa->erreur = 0;
+    fa->f = fopen(chemin, "rb");
+    if (!fa->f) return -1;
+    t_entete_binaire e;
+    if (fread(&e, sizeof(e), 1, fa->f) == 1 && e.magic == BINAIRE_MAGIC && e.n > 0) {
+        fa->binaire = 1;
+        fa->n = e.n;
+    } else {
+        fa->binaire = 0;
+        rewind(fa->f);
+        if (fscanf(fa->f, "%d", &fa->n) != 1 || fa->n <= 0) {
+            fclose(fa->f);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* revient au début des arêtes : on relit l'en-tête plutôt que d'utiliser
+ ftell/fseek, limités à 2 Go avec un 'long' 32 bits (Windows) */
+void rembobinerFichierAretes(t_fichier_aretes *fa) {
+    rewind(fa->f);
+    if (fa->binaire) {
+        t_entete_binaire e;
+        if (fread(&e, sizeof(e), 1, fa->f) != 1) fa->erreur = 1;
+    } else {
+        int n;
+        if (fscanf(fa->f, "%d", &n) != 1) fa->erreur = 1;
+    }
+}
+
+/* lit au plus max arêtes dans dst, renvoie le nombre lu (0 : fin du fichier).
+ Une ligne mal formée ou un enregistrement tronqué positionne fa->erreur :
+ ce n'est pas une fin de fichier. */
+long lireAretes(t_fichier_aretes *fa, t_arete_binaire *dst, long max) {
+    if (fa->binaire) {
+        size_t octets = fread(dst, 1, max * sizeof(t_arete_binaire), fa->f);
+        if (octets % sizeof(t_arete_binaire) != 0 || ferror(fa->f)) fa->erreur = 1;
+        return (long)(octets / sizeof(t_arete_binaire));
+    }
+    long nb = 0;
+    while (nb < max) {
+        int r = fscanf(fa->f, "%d %d %f", &dst[nb].depart, &dst[nb].arrivee, &dst[nb].proba);
+        if (r == 3) {
+            nb++;
+            continue;
+        }
+        if (r != EOF || ferror(fa->f)) fa->erreur = 1;
+        break;
+    }
+    return nb;
+}
+
+void fermerFichierAretes(t_fichier_aretes *fa) {
+    if (fa->f) fclose(fa->f);
+    fa->f = NULL;
+}
+
+/* thread lecteur, unique pour toute la résolution : à chaque passage demandé,
+ relit tout le fichier en alternant les deux blocs et termine par un bloc vide */
+static void *lecteur(void *arg) {
+    t_flux *fl = (t_flux*)arg;
+    int fait = 0;
+    for (;;) {
+        pthread_mutex_lock(&fl->verrou);
+        while (fl->passes == fait && !fl->arret) pthread_cond_wait(&fl->change, &fl->verrou);
+        if (fl->arret) {
+            pthread_mutex_unlock(&fl->verrou);
+            break;
+        }
+        fait = fl->passes;
+        pthread_mutex_unlock(&fl->verrou);
+
+        rembobinerFichierAretes(&fl->fa);
+        int i = 0;
+        for (;;) {
+            pthread_mutex_lock(&fl->verrou);
+            while (fl->blocs[i].plein) pthread_cond_wait(&fl->change, &fl->verrou);
+            pthread_mutex_unlock(&fl->verrou);
+
+            long nb = fl->fa.erreur ? 0 : lireAretes(&fl->fa, fl->blocs[i].aretes, fl->taille_bloc);
+
+            pthread_mutex_lock(&fl->verrou);
+            fl->blocs[i].nb = nb;
+            fl->blocs[i].plein = 1;
+            if (fl->fa.erreur || (nb == 0 && ferror(fl->fa.f))) fl->erreur = 1;
+            pthread_cond_broadcast(&fl->change);
+            pthread_mutex_unlock(&fl->verrou);
+            if (nb == 0) break;
+            i ^= 1;
+        }
+    }
+    return NULL;
+}
+
+/* out = vec * P sur un passage complet du fichier ; renvoie 0 ou -1 (erreur de lecture) */
+static int passage(t_flux *fl, float *vec, float *out) {
+    for (int j = 0; j < fl->n; j++) out[j] = 0.0f;
+    /* le lecteur attend la demande : les deux blocs sont libres */
+    pthread_mutex_lock(&fl->verrou);
+    fl->blocs[0].plein = fl->blocs[1].plein = 0;
+    fl->passes++;
+    pthread_cond_broadcast(&fl->change);
+    pthread_mutex_unlock(&fl->verrou);
+    int i = 0;
+    for (;;) {
+        pthread_mutex_lock(&fl->verrou);
+        while (!fl->blocs[i].plein) pthread_cond_wait(&fl->change, &fl->verrou);
+        long nb = fl->blocs[i].nb;
+        pthread_mutex_unlock(&fl->verrou);
+        if (nb == 0) break;
+
+        t_arete_binaire *a = fl->blocs[i].aretes;
+        for (long k = 0; k < nb; k++) {
+            int d = a[k].depart, c = a[k].arrivee;
+            if (d >= 1 && d <= fl->n && c >= 1 && c <= fl->n) {
+                out[c - 1] += vec[d - 1] * a[k].proba;
+            }
+        }
+
+        pthread_mutex_lock(&fl->verrou);
+        fl->blocs[i].plein = 0;
+        pthread_cond_broadcast(&fl->change);
+        pthread_mutex_unlock(&fl->verrou);
+        i ^= 1;
+    }
+    pthread_mutex_lock(&fl->verrou);
+    int erreur = fl->erreur;
+    pthread_mutex_unlock(&fl->verrou);
+    return erreur ? -1 : 0;
+}
+
+/* nombre de sommets déclaré par un fichier (texte ou binaire), -1 si illisible */
+int nombreSommetsFichier(const char *chemin) {
+    t_fichier_aretes fa;
+    if (ouvrirFichierAretes(&fa, chemin) != 0) return -1;
+    fermerFichierAretes(&fa);
+    return fa.n;
+}
+
+/* stationnaireHorsMemoire
+ Itération de puissance pi <- pi * P en relisant le fichier à chaque pas.
+ pi (taille n, cf. nombreSommetsFichier) sert de point de départ s'il est non nul,
+ sinon on part de la loi uniforme. Renvoie le nombre d'itérations, -1 en cas d'erreur.
+ */
+int stationnaireHorsMemoire(const char *chemin, float *pi, float epsilon, int max_iter, long taille_bloc) {
+    t_flux fl;
+    memset(&fl, 0, sizeof(fl));
+    if (ouvrirFichierAretes(&fl.fa, chemin) != 0) return -1;
+    fl.n = fl.fa.n;
+    fl.taille_bloc = taille_bloc > 0 ? taille_bloc : BLOC_DEFAUT;
+    for (int b = 0; b < 2; b++) {
+        fl.blocs[b].aretes = (t_arete_binaire*)malloc(fl.taille_bloc * sizeof(t_arete_binaire));
+        if (!fl.blocs[b].aretes) erreurFatale("alloc bloc hors mémoire");
+    }
+    pthread_mutex_init(&fl.verrou, NULL);
+    pthread_cond_init(&fl.change, NULL);
+
+    int n = fl.n;
+    float masse = 0.0f;
+    for (int i = 0; i < n; i++) masse += pi[i];
+    if (masse == 0.0f) {
+        for (int i = 0; i < n; i++) pi[i] = 1.0f / n;
+    }
+    pthread_t t;
+    if (pthread_create(&t, NULL, lecteur, &fl) != 0) {
+        free(fl.blocs[0].aretes);
+        free(fl.blocs[1].aretes);
+        pthread_mutex_destroy(&fl.verrou);
+        pthread_cond_destroy(&fl.change);
+        fermerFichierAretes(&fl.fa);
+        return -1;
+    }
+    float *tmp = createZeroVector(n);
+    int iter = 0;
+    while (iter < max_iter) {
+        if (passage(&fl, pi, tmp) != 0) {
+            iter = -1;
+            break;
+        }
+        float d = diffVectors(pi, tmp, n);
+        copyVector(pi, tmp, n);
+        iter++;
+        if (d < epsilon) break;
+    }
+    pthread_mutex_lock(&fl.verrou);
+    fl.arret = 1;
+    pthread_cond_broadcast(&fl.change);
+    pthread_mutex_unlock(&fl.verrou);
+    pthread_join(t, NULL);
+    freeVector(tmp);
+    free(fl.blocs[0].aretes);
+    free(fl.blocs[1].aretes);
+    pthread_mutex_destroy(&fl.verrou);
+    pthread_cond_destroy(&fl.change);
+    fermerFichierAretes(&fl.fa);
+    return iter;
+}
+
+/* convertirTexteEnBinaire
+ Conversion en flux (sans charger le graphe) du format texte vers le format
+ binaire, plus rapide à relire. Renvoie le nombre d'arêtes écrites, -1 en cas d'erreur
+ (fichier illisible ou ligne mal formée ; le fichier binaire est alors supprimé).
+ */
+long long convertirTexteEnBinaire(const char *texte, const char *binaire) {
+    t_fichier_aretes in;
+    if (ouvrirFichierAretes(&in, texte) != 0) return -1;
+    FILE *out = fopen(binaire, "wb");
+    if (!out) {
+        fermerFichierAretes(&in);
+        return -1;
+    }
+    t_entete_binaire e;
+    e.magic = BINAIRE_MAGIC;
+    e.n = in.n;
+    e.nnz = 0;
+    fwrite(&e, sizeof(e), 1, out);
+    t_arete_binaire a;
+    while (lireAretes(&in, &a, 1) == 1) {
+        if (a.depart < 1 || a.depart > e.n || a.arrivee < 1 || a.arrivee > e.n) continue;
+        fwrite(&a, sizeof(a), 1, out);
+        e.nnz++;
+    }
+    int mal_forme = in.erreur;
+    fermerFichierAretes(&in);
+    if (mal_forme) {
+        fclose(out);
+        remove(binaire);
+        return -1;
+    }
+    /* réécriture de l'en-tête avec le nombre d'arêtes */
+    fseek(out, 0, SEEK_SET);
+    fwrite(&e, sizeof(e), 1, out);
+    int err = ferror(out);
+    if (fclose(out) != 0 || err) {
+        remove(binaire);
+        return -1;
+    }
+    return e.nnz;
+}
@@ -0,0 +1,152 @@
+#include "precision.h"
+#include <float.h>
+
+/* nombre d'itérations sans amélioration de l'écart avant de passer en double */
+#define STAGNATION_MAX 32
+
+/*
+   DEFINIR_NOYAUX(T, S) : produits vecteur-matrice, écart L1 et itération de
+   puissance pour le type T, fonctions suffixées par S. L'itération s'arrête
+   quand l'écart passe sous epsilon (renvoie le nombre d'itérations, le vecteur
+   final dans p) ; le produit est tiré (spmv.h, écart cumulé par tranche) si
+   'sp' est fourni, sinon poussé depuis la liste d'adjacence ou la CSR.
+   Si 'plancher' > 0, elle s'arrête aussi dès que l'écart passe sous ce
+   plancher ou ne diminue plus depuis STAGNATION_MAX itérations, et *stagne
+   vaut alors 1.
+*/
+#define DEFINIR_NOYAUX(T, S)                                                          \
+void multiplyVectorAdjacency_##S(const T *vec, liste_adjacence la, T *out) {          \
+    for (int j = 0; j < la.taille; j++) out[j] = 0;                                   \
+    for (int i = 0; i < la.taille; i++) {                                             \
+        T vi = vec[i];                                                                \
+        if (vi == 0) continue;                                                        \
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) {                        \
+            out[c->arrivee - 1] += vi * (T)c->proba;                                  \
+        }                                                                             \
+    }                                                                                 \
+}                                                                                     \
+                                                                                      \
+void multiplyVectorCSR_##S(const T *vec, t_csr *m, T *out) {                          \
+    for (int j = 0; j < m->n; j++) out[j] = 0;                                        \
+    for (int i = 0; i < m->n; i++) {                                                  \
+        T vi = vec[i];                                                                \
+        if (vi == 0) continue;                                                        \
+        for (long k = m->debut[i]; k < m->debut[i + 1]; k++) {                        \
+            out[m->colonnes[k]] += vi * (T)m->valeurs[k];                             \
+        }                                                                             \
+    }                                                                                 \
+}                                                                                     \
+                                                                                      \
+T diffVectors_##S(const T *v1, const T *v2, int n) {                                  \
+    T d = 0;                                                                          \
+    for (int i = 0; i < n; i++) d += v1[i] > v2[i] ? v1[i] - v2[i] : v2[i] - v1[i];   \
+    return d;                                                                         \
+}                                                                                     \
+                                                                                      \
+static int iterer_##S(liste_adjacence *la, t_csr *m, const t_spmv *sp, int n, T *p,   \
+                      T epsilon, int max_iter, T plancher, int *stagne) {             \
+    T *tmp = (T*)malloc((n + 1) * sizeof(T));                                         \
+    if (!tmp) erreurFatale("alloc iteration");                                        \
+    suivreRessource(tmp, free);                                                       \
+    T meilleur = -1;                                                                  \
+    int sans_progres = 0;                                                             \
+    int iter = 0;                                                                     \
+    if (stagne) *stagne = 0;                                                          \
+    while (iter < max_iter) {                                                         \
+        T d;                                                                          \
+        if (sp) {                                                                     \
+            d = multiplierSpmv_##S(sp, p, tmp);                                       \
+        } else {                                                                      \
+            if (la) multiplyVectorAdjacency_##S(p, *la, tmp);                         \
+            else multiplyVectorCSR_##S(p, m, tmp);                                    \
+            d = diffVectors_##S(p, tmp, n);                                           \
+        }                                                                             \
+        memcpy(p, tmp, n * sizeof(T));                                                \
+        if (d < epsilon) break;                                                       \
+        iter++;                                                                       \
+        if (plancher > 0) {                                                           \
+            if (meilleur < 0 || d < meilleur) {                                       \
+                meilleur = d;                                                         \
+                sans_progres = 0;                                                     \
+            } else {                                                                  \
+                sans_progres++;                                                       \
+            }                                                                         \
+            if (d < plancher || sans_progres >= STAGNATION_MAX) {                     \
+                *stagne = 1;                                                          \
+                break;                                                                \
+            }                                                                         \
+        }                                                                             \
+    }                                                                                 \
+    oublierRessource(tmp);                                                            \
+    free(tmp);                                                                        \
+    return iter;                                                                      \
+}
+
+DEFINIR_NOYAUX(float, f)
+DEFINIR_NOYAUX(double, d)
+
+/* lit "simple", "double" ou "mixte" ; renvoie 0 si reconnu, -1 sinon */
+int precisionDepuisNom(const char *nom, t_precision *prec) {
+    if (strcmp(nom, "simple") == 0) *prec = PRECISION_SIMPLE;
+    else if (strcmp(nom, "double") == 0) *prec = PRECISION_DOUBLE;
+    else if (strcmp(nom, "mixte") == 0) *prec = PRECISION_MIXTE;
+    else return -1;
+    return 0;
+}
+
+const char *nomPrecision(t_precision prec) {
+    switch (prec) {
+        case PRECISION_SIMPLE: return "simple";
+        case PRECISION_DOUBLE: return "double";
+        default: return "mixte";
+    }
+}
+
+/* precisionPourSpectre
+ Choix a priori d'après l'estimation spectrale : en float, l'itéré fixe
+ s'écarte du vrai vecteur d'environ n * FLT_EPSILON * temps de mélange. Si
+ cet écart dépasse déjà epsilon, la phase float du mode mixte ne peut que
+ stagner : on itère directement en double. Les autres modes sont inchangés.
+ */
+t_precision precisionPourSpectre(t_precision prec, float temps_melange, int n, float epsilon) {
+    if (prec != PRECISION_MIXTE || temps_melange <= 0.0f) return prec;
+    if ((double)temps_melange * n * FLT_EPSILON >= epsilon) return PRECISION_DOUBLE;
+    return prec;
+}
+
+/* itération de puissance sur la liste d'adjacence, la CSR ou le produit tiré, selon la précision */
+static int puissance(liste_adjacence *la, t_csr *m, const t_spmv *sp, int n, float *p,
+                     float epsilon, int max_iter, t_precision prec) {
+    int iter = 0;
+    if (prec == PRECISION_SIMPLE) {
+        return iterer_f(la, m, sp, n, p, epsilon, max_iter, 0.0f, NULL);
+    }
+    if (prec == PRECISION_MIXTE) {
+        /* le bruit d'arrondi de l'écart L1 croît comme n * FLT_EPSILON */
+        float plancher = 16.0f * n * FLT_EPSILON;
+        int stagne = 0;
+        iter = iterer_f(la, m, sp, n, p, epsilon, max_iter, plancher, &stagne);
+        if (!stagne) return iter;
+    }
+    double *pd = (double*)malloc((n + 1) * sizeof(double));
+    if (!pd) erreurFatale("alloc iteration");
+    suivreRessource(pd, free);
+    for (int i = 0; i < n; i++) pd[i] = p[i];
+    iter += iterer_d(la, m, sp, n, pd, epsilon, max_iter - iter, 0.0, NULL);
+    oublierRessource(pd);
+    for (int i = 0; i < n; i++) p[i] = (float)pd[i];
+    free(pd);
+    return iter;
+}
+
+int puissanceAdjacence(liste_adjacence la, float *p, float epsilon, int max_iter, t_precision prec) {
+    return puissance(&la, NULL, NULL, la.taille, p, epsilon, max_iter, prec);
+}
+
+int puissanceCSR(t_csr *m, float *p, float epsilon, int max_iter, t_precision prec) {
+    return puissance(NULL, m, NULL, m->n, p, epsilon, max_iter, prec);
+}
+
+int puissanceSpmv(const t_spmv *s, float *p, float epsilon, int max_iter, t_precision prec) {
+    return puissance(NULL, NULL, s, s->transposee.n, p, epsilon, max_iter, prec);
+}
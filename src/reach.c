@@ -0,0 +1,225 @@
+#include "reach.h"
+
+/* fonction de libération pour suivreRessource */
+void ressourceReach(void *r) {
+    free_reachability_index((t_reachability*)r);
+}
+
+/* construit le DAG des classes au format CSR (liens dédoublonnés par add_link_if_not_exists) */
+static void build_class_csr(t_reachability *r, t_link_array *links) {
+    int nb = r->nb;
+    r->succ_start = (int*)calloc(nb + 2, sizeof(int));
+    r->succ = (int*)malloc((links->size + 1) * sizeof(int));
+    if (!r->succ_start || !r->succ) { erreurFatale("alloc reach csr"); }
+    for (int k = 0; k < links->size; k++) r->succ_start[links->links[k].from + 1]++;
+    for (int c = 1; c <= nb + 1; c++) r->succ_start[c] += r->succ_start[c - 1];
+    int *pos = (int*)malloc((nb + 1) * sizeof(int));
+    if (!pos) { erreurFatale("alloc reach csr"); }   // r est suivi par build_reachability_index
+    memcpy(pos, r->succ_start, (nb + 1) * sizeof(int));
+    for (int k = 0; k < links->size; k++) {
+        r->succ[pos[links->links[k].from]++] = links->links[k].to;
+    }
+    free(pos);
+}
+
+/* ordre topologique inverse (puits d'abord) par DFS itératif */
+static int *reverse_topological_order(t_reachability *r) {
+    int nb = r->nb;
+    int *order = (int*)malloc(nb * sizeof(int));
+    int *state = (int*)calloc(nb + 1, sizeof(int));
+    int *next = (int*)malloc((nb + 1) * sizeof(int));
+    if (!order || !state || !next) {
+        free(order);
+        free(state);
+        free(next);
+        erreurFatale("alloc reach order");
+    }
+    suivreRessource(order, free);
+    suivreRessource(state, free);
+    suivreRessource(next, free);
+    int count = 0;
+    int_stack s;
+    init_stack(&s);
+    suivreRessource(&s, ressourcePile);
+    for (int root = 1; root <= nb; root++) {
+        if (state[root]) continue;
+        state[root] = 1;
+        next[root] = r->succ_start[root];
+        push_stack(&s, root);
+        while (!stack_empty(&s)) {
+            int c = s.data[s.top - 1];
+            if (next[c] < r->succ_start[c + 1]) {
+                int d = r->succ[next[c]++];
+                if (!state[d]) {
+                    state[d] = 1;
+                    next[d] = r->succ_start[d];
+                    push_stack(&s, d);
+                }
+            } else {
+                pop_stack(&s);
+                order[count++] = c;
+            }
+        }
+    }
+    oublierRessource(&s);
+    oublierRessource(next);
+    oublierRessource(state);
+    oublierRessource(order);
+    free_stack(&s);
+    free(next);
+    free(state);
+    return order;
+}
+
+/* fermeture transitive : ligne(c) = {c} U lignes des successeurs, puits d'abord */
+static void build_bitset(t_reachability *r) {
+    r->words = (r->nb + 63) / 64;
+    r->bits = (uint64_t*)calloc((size_t)r->words * (r->nb + 1), sizeof(uint64_t));
+    if (!r->bits) { erreurFatale("alloc reach bitset"); }
+    int *order = reverse_topological_order(r);   // aucune allocation jusqu'au free
+    for (int k = 0; k < r->nb; k++) {
+        int c = order[k];
+        uint64_t *row = r->bits + (size_t)c * r->words;
+        row[(c - 1) / 64] |= 1ULL << ((c - 1) % 64);
+        for (int e = r->succ_start[c]; e < r->succ_start[c + 1]; e++) {
+            uint64_t *srow = r->bits + (size_t)r->succ[e] * r->words;
+            for (int w = 0; w < r->words; w++) row[w] |= srow[w];
+        }
+    }
+    free(order);
+}
+
+/* étiquetage par intervalles : pre/post d'une forêt couvrante DFS et low = min(post) des descendants */
+static void build_intervals(t_reachability *r) {
+    int nb = r->nb;
+    r->pre = (int*)malloc((nb + 1) * sizeof(int));
+    r->post = (int*)malloc((nb + 1) * sizeof(int));
+    r->low = (int*)malloc((nb + 1) * sizeof(int));
+    int *next = (int*)malloc((nb + 1) * sizeof(int));
+    if (!r->pre || !r->post || !r->low || !next) {
+        free(next);
+        erreurFatale("alloc reach intervals");
+    }
+    suivreRessource(next, free);
+    for (int c = 1; c <= nb; c++) r->pre[c] = -1;
+    int clock_pre = 0, clock_post = 0;
+    int_stack s;
+    init_stack(&s);
+    suivreRessource(&s, ressourcePile);
+    for (int root = 1; root <= nb; root++) {
+        if (r->pre[root] != -1) continue;
+        r->pre[root] = clock_pre++;
+        next[root] = r->succ_start[root];
+        push_stack(&s, root);
+        while (!stack_empty(&s)) {
+            int c = s.data[s.top - 1];
+            if (next[c] < r->succ_start[c + 1]) {
+                int d = r->succ[next[c]++];
+                if (r->pre[d] == -1) {
+                    r->pre[d] = clock_pre++;
+                    next[d] = r->succ_start[d];
+                    push_stack(&s, d);
+                }
+            } else {
+                pop_stack(&s);
+                r->post[c] = clock_post++;
+                /* tous les successeurs sont terminés (DAG) : low est définitif */
+                int low = r->post[c];
+                for (int e = r->succ_start[c]; e < r->succ_start[c + 1]; e++) {
+                    if (r->low[r->succ[e]] < low) low = r->low[r->succ[e]];
+                }
+                r->low[c] = low;
+            }
+        }
+    }
+    oublierRessource(&s);
+    oublierRessource(next);
+    free_stack(&s);
+    free(next);
+}
+
+/* build_reachability_index
+ Construit l'index à partir de la partition (Tarjan), des liens entre classes
+ (bruts ou Hasse : l'accessibilité est la même) et de la table sommet -> classe.
+ */
+t_reachability build_reachability_index(t_partition *p, t_link_array *links, int *vertex_to_class, int n) {
+    t_reachability r;
+    memset(&r, 0, sizeof(r));
+    r.n = n;
+    r.nb = p->nb;
+    suivreRessource(&r, ressourceReach);
+    r.vertex_to_class = (int*)malloc((n + 1) * sizeof(int));
+    if (!r.vertex_to_class) { erreurFatale("alloc reach map"); }
+    memcpy(r.vertex_to_class, vertex_to_class, (n + 1) * sizeof(int));
+    build_class_csr(&r, links);
+    if (r.nb <= REACH_BITSET_MAX_CLASSES) {
+        build_bitset(&r);
+    } else {
+        build_intervals(&r);
+    }
+    oublierRessource(&r);
+    return r;
+}
+
+/* parcours élagué : descend seulement dans les classes dont l'intervalle peut contenir 'to' */
+static int pruned_search(t_reachability *r, int from, int to) {
+    /* marques locales : l'index reste en lecture seule */
+    char *mark = (char*)calloc(r->nb + 1, sizeof(char));
+    if (!mark) { erreurFatale("alloc reach search"); }
+    suivreRessource(mark, free);
+    int found = 0;
+    int_stack s;
+    init_stack(&s);
+    suivreRessource(&s, ressourcePile);
+    push_stack(&s, from);
+    mark[from] = 1;
+    while (!stack_empty(&s) && !found) {
+        int c = pop_stack(&s);
+        for (int e = r->succ_start[c]; e < r->succ_start[c + 1]; e++) {
+            int d = r->succ[e];
+            if (d == to) { found = 1; break; }
+            if (mark[d]) continue;
+            mark[d] = 1;
+            if (r->low[to] < r->low[d] || r->post[to] > r->post[d]) continue;
+            push_stack(&s, d);
+        }
+    }
+    oublierRessource(&s);
+    oublierRessource(mark);
+    free_stack(&s);
+    free(mark);
+    return found;
+}
+
+/* renvoie 1 si la classe 'to' est atteignable depuis la classe 'from' (1-based) */
+int class_can_reach(t_reachability *r, int from, int to) {
+    if (from == to) return 1;
+    if (r->bits) {
+        const uint64_t *row = r->bits + (size_t)from * r->words;
+        return (int)((row[(to - 1) / 64] >> ((to - 1) % 64)) & 1ULL);
+    }
+    /* test positif : 'to' est dans le sous-arbre couvrant de 'from' */
+    if (r->pre[from] <= r->pre[to] && r->post[to] <= r->post[from]) return 1;
+    /* test négatif : intervalle [low, post] de 'to' hors de celui de 'from' */
+    if (r->low[to] < r->low[from] || r->post[to] > r->post[from]) return 0;
+    return pruned_search(r, from, to);
+}
+
+/* renvoie 1 si le sommet j est atteignable depuis le sommet i (1-based, chemin de longueur >= 0). */
+int can_reach(t_reachability *r, int i, int j) {
+    if (i < 1 || i > r->n || j < 1 || j > r->n) return 0;
+    return class_can_reach(r, r->vertex_to_class[i], r->vertex_to_class[j]);
+}
+
+/* libère l'index */
+void free_reachability_index(t_reachability *r) {
+    if (!r) return;
+    free(r->vertex_to_class);
+    free(r->bits);
+    free(r->succ_start);
+    free(r->succ);
+    free(r->pre);
+    free(r->post);
+    free(r->low);
+    memset(r, 0, sizeof(*r));
+}
@@ -0,0 +1,237 @@
+#include "recompense.h"
+#include "sparse.h"
+#include "reorder.h"
+
+/* lireRecompenses
+ Fichier texte, une ligne par état : "etat r1 r2 ... rK" (K colonnes fixées par
+ la première ligne ; lignes vides et commençant par '#' ignorées, états
+ absents à 0). recompenses[(etat-1) * K + k] est alloué ici.
+ Renvoie 0, -1 si le fichier est illisible, -2 si une ligne est invalide
+ (état hors de 1..n ou nombre de colonnes différent).
+ */
+int lireRecompenses(const char *fichier, int n, double **recompenses, int *nb_recompenses) {
+    FILE *f = fopen(fichier, "rt");
+    if (!f) return -1;
+    char ligne[4096];
+    double vals[256];
+    double *r = NULL;
+    int k = 0, res = 0;
+    while (fgets(ligne, sizeof(ligne), f)) {
+        char *p = ligne, *fin;
+        while (*p == ' ' || *p == '\t') p++;
+        if (*p == '#' || *p == '\n' || *p == '\r' || *p == '\0') continue;
+        long etat = strtol(p, &fin, 10);
+        if (fin == p || etat < 1 || etat > n) {
+            res = -2;
+            break;
+        }
+        int nb = 0;
+        for (p = fin;; p = fin) {
+            double v = strtod(p, &fin);
+            if (fin == p || nb == 256) break;
+            vals[nb++] = v;
+        }
+        if (nb == 0 || (k > 0 && nb != k)) {
+            res = -2;
+            break;
+        }
+        if (!r) {
+            k = nb;
+            r = (double*)calloc((size_t)n * k, sizeof(double));
+            if (!r) erreurFatale("alloc recompenses");
+        }
+        memcpy(r + (size_t)(etat - 1) * k, vals, k * sizeof(double));
+    }
+    fclose(f);
+    if (res == 0 && !r) res = -2;
+    if (res != 0) {
+        free(r);
+        return res;
+    }
+    *recompenses = r;
+    *nb_recompenses = k;
+    return 0;
+}
+
+/* resoudreBloc
+ x = c + gamma .* (B x) sur la sous-chaîne B d'une classe, m systèmes entrelacés
+ (x[r * m + s]). x contient le point de départ. Arrêt quand la plus grande
+ mise à jour d'un balayage passe sous tolerance. y (Jacobi) et acc sont des
+ tampons de travail. Renvoie le nombre de balayages.
+ */
+static int resoudreBloc(const t_csr *b, double *x, const double *c, const double *gammas, int m,
+                        t_methode_valeur methode, double tolerance, int max_iter,
+                        double *y, double *acc, double *residu) {
+    double *dest = methode == VALEUR_GAUSS_SEIDEL ? x : y;
+    double res = 0.0;
+    int it = 0;
+    *residu = 0.0;
+    if (b->nnz == 0) return 0;
+    while (it < max_iter) {
+        res = 0.0;
+        for (int r = 0; r < b->n; r++) {
+            for (int s = 0; s < m; s++) acc[s] = 0.0;
+            for (long e = b->debut[r]; e < b->debut[r + 1]; e++) {
+                double p = b->valeurs[e];
+                const double *xj = x + (size_t)b->colonnes[e] * m;
+                for (int s = 0; s < m; s++) acc[s] += p * xj[s];
+            }
+            for (int s = 0; s < m; s++) {
+                double v = c[(size_t)r * m + s] + gammas[s] * acc[s];
+                double d = fabs(v - x[(size_t)r * m + s]);
+                if (d > res) res = d;
+                dest[(size_t)r * m + s] = v;
+            }
+        }
+        if (dest != x) memcpy(x, y, (size_t)b->n * m * sizeof(double));
+        it++;
+        if (res < tolerance) break;
+    }
+    *residu = res;
+    return it;
+}
+
+/* distribution stationnaire d'une classe persistante par puissance sur la
+   chaîne paresseuse (I + B) / 2 : même distribution, mais apériodique */
+static void stationnaireBloc(const t_csr *b, double *pi, double *tmp, double tolerance, int max_iter) {
+    int n = b->n;
+    for (int r = 0; r < n; r++) pi[r] = 1.0 / n;
+    for (int it = 0; it < max_iter; it++) {
+        for (int r = 0; r < n; r++) tmp[r] = 0.5 * pi[r];
+        for (int r = 0; r < n; r++) {
+            double v = 0.5 * pi[r];
+            for (long e = b->debut[r]; e < b->debut[r + 1]; e++) tmp[b->colonnes[e]] += v * b->valeurs[e];
+        }
+        double d = 0.0;
+        for (int r = 0; r < n; r++) {
+            d += fabs(tmp[r] - pi[r]);
+            pi[r] = tmp[r];
+        }
+        if (d < tolerance) break;
+    }
+    double somme = 0.0;
+    for (int r = 0; r < n; r++) somme += pi[r];
+    if (somme > 0.0) {
+        for (int r = 0; r < n; r++) pi[r] /= somme;
+    }
+}
+
+/* calculerValeurs
+ recompenses[(i-1) * nb_recompenses + k], facteurs[f] dans [0, 1). 'liens'
+ donne l'ordre des classes (liens bruts ou diagramme de Hasse). Renvoie 0, -1
+ si les arguments sont invalides. Les valeurs sont calculées en double.
+ */
+int calculerValeurs(liste_adjacence la, t_partition *p, int *vertex_to_class, t_link_array *liens,
+                    const double *recompenses, int nb_recompenses,
+                    const double *facteurs, int nb_facteurs,
+                    t_methode_valeur methode, double tolerance, int max_iter, t_valeurs *out) {
+    if (nb_recompenses <= 0 || nb_facteurs <= 0) return -1;
+    for (int f = 0; f < nb_facteurs; f++) {
+        if (!(facteurs[f] >= 0.0 && facteurs[f] < 1.0)) return -1;
+    }
+    int n = la.taille, K = nb_recompenses, m = nb_recompenses * nb_facteurs;
+    out->n = n;
+    out->nb_recompenses = K;
+    out->nb_facteurs = nb_facteurs;
+    out->nb_systemes = m;
+    out->iterations = 0;
+    out->residu = 0.0;
+    out->valeurs = (double*)calloc((size_t)n * m, sizeof(double));
+    out->gain = (double*)calloc((size_t)n * K, sizeof(double));
+    out->persistante = (int*)malloc((p->nb + 1) * sizeof(int));
+    double *gammas = (double*)malloc((m + K) * sizeof(double));
+    if (!out->valeurs || !out->gain || !out->persistante || !gammas) erreurFatale("alloc valeurs");
+    double *uns = gammas + m;   // facteur 1 pour les gains des classes transitoires
+    for (int s = 0; s < m; s++) gammas[s] = facteurs[s % nb_facteurs];
+    for (int k = 0; k < K; k++) uns[k] = 1.0;
+
+    /* une classe est persistante si aucune arête n'en sort */
+    for (int c = 0; c < p->nb; c++) out->persistante[c] = 1;
+    for (int u = 1; u <= n; u++) {
+        for (cellule *e = la.tab[u - 1].head; e; e = e->suivant) {
+            if (vertex_to_class[e->arrivee] != vertex_to_class[u]) out->persistante[vertex_to_class[u] - 1] = 0;
+        }
+    }
+
+    int taille_max = 1;
+    for (int c = 0; c < p->nb; c++) {
+        if (p->classes[c].size > taille_max) taille_max = p->classes[c].size;
+    }
+    int larg = m > K ? m : K;
+    double *x = (double*)malloc((size_t)taille_max * larg * sizeof(double));
+    double *cst = (double*)malloc((size_t)taille_max * larg * sizeof(double));
+    double *y = (double*)malloc((size_t)taille_max * larg * sizeof(double));
+    double *acc = (double*)malloc(larg * sizeof(double));
+    if (!x || !cst || !y || !acc) erreurFatale("alloc valeurs");
+
+    t_csr *blocs = extraireSousChaines(la, p, vertex_to_class);
+    int *ordre = ordreTopologiqueClasses(p, liens);
+    for (int o = p->nb - 1; o >= 0; o--) {
+        int c = ordre[o] - 1;
+        t_classe *cl = &p->classes[c];
+        double residu;
+        int it;
+
+        /* valeurs actualisées : terme constant = récompense + aval déjà résolu */
+        for (int r = 0; r < cl->size; r++) {
+            int i = cl->members[r];
+            double *cr = cst + (size_t)r * m;
+            for (int s = 0; s < m; s++) cr[s] = recompenses[(size_t)(i - 1) * K + s / nb_facteurs];
+            for (cellule *e = la.tab[i - 1].head; e; e = e->suivant) {
+                if (vertex_to_class[e->arrivee] == c + 1) continue;
+                const double *vj = out->valeurs + (size_t)(e->arrivee - 1) * m;
+                for (int s = 0; s < m; s++) cr[s] += gammas[s] * e->proba * vj[s];
+            }
+        }
+        memcpy(x, cst, (size_t)cl->size * m * sizeof(double));
+        it = resoudreBloc(&blocs[c], x, cst, gammas, m, methode, tolerance, max_iter, y, acc, &residu);
+        if (it > out->iterations) out->iterations = it;
+        if (residu > out->residu) out->residu = residu;
+        for (int r = 0; r < cl->size; r++) {
+            memcpy(out->valeurs + (size_t)(cl->members[r] - 1) * m, x + (size_t)r * m, m * sizeof(double));
+        }
+
+        /* gains */
+        if (out->persistante[c]) {
+            stationnaireBloc(&blocs[c], x, y, tolerance, max_iter);
+            for (int k = 0; k < K; k++) {
+                double g = 0.0;
+                for (int r = 0; r < cl->size; r++) g += x[r] * recompenses[(size_t)(cl->members[r] - 1) * K + k];
+                for (int r = 0; r < cl->size; r++) out->gain[(size_t)(cl->members[r] - 1) * K + k] = g;
+            }
+        } else {
+            for (int r = 0; r < cl->size; r++) {
+                int i = cl->members[r];
+                double *cr = cst + (size_t)r * K;
+                for (int k = 0; k < K; k++) cr[k] = 0.0;
+                for (cellule *e = la.tab[i - 1].head; e; e = e->suivant) {
+                    if (vertex_to_class[e->arrivee] == c + 1) continue;
+                    const double *gj = out->gain + (size_t)(e->arrivee - 1) * K;
+                    for (int k = 0; k < K; k++) cr[k] += e->proba * gj[k];
+                }
+            }
+            memcpy(x, cst, (size_t)cl->size * K * sizeof(double));
+            resoudreBloc(&blocs[c], x, cst, uns, K, methode, tolerance, max_iter, y, acc, &residu);
+            for (int r = 0; r < cl->size; r++) {
+                memcpy(out->gain + (size_t)(cl->members[r] - 1) * K, x + (size_t)r * K, K * sizeof(double));
+            }
+        }
+    }
+    free(ordre);
+    libererSousChaines(blocs, p->nb);
+    free(x);
+    free(cst);
+    free(y);
+    free(acc);
+    free(gammas);
+    return 0;
+}
+
+void libererValeurs(t_valeurs *v) {
+    if (!v) return;
+    free(v->valeurs);
+    free(v->gain);
+    free(v->persistante);
+    v->valeurs = v->gain = NULL;
+    v->persistante = NULL;
+}
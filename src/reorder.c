@@ -0,0 +1,307 @@
+#include "reorder.h"
+#include "matrix.h"
+
+/* graphe non orienté (arêtes sortantes + entrantes) au format CSR, 1-based */
+typedef struct {
+    int *debut;   // debut[v]..debut[v+1]-1 dans voisins, v = 1..n
+    int *voisins;
+} t_voisinage;
+
+static t_voisinage construireVoisinage(liste_adjacence la) {
+    int n = la.taille;
+    t_voisinage g;
+    g.debut = (int*)calloc(n + 2, sizeof(int));
+    if (!g.debut) { erreurFatale("alloc voisinage"); }
+    for (int i = 0; i < n; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) {
+            g.debut[i + 2]++;
+            g.debut[c->arrivee + 1]++;
+        }
+    }
+    for (int v = 1; v <= n + 1; v++) g.debut[v] += g.debut[v - 1];
+    g.voisins = (int*)malloc((g.debut[n + 1] + 1) * sizeof(int));
+    int *pos = (int*)malloc((n + 2) * sizeof(int));
+    if (!g.voisins || !pos) { erreurFatale("alloc voisinage"); }
+    memcpy(pos, g.debut, (n + 2) * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) {
+            g.voisins[pos[i + 1]++] = c->arrivee;
+            g.voisins[pos[c->arrivee]++] = i + 1;
+        }
+    }
+    free(pos);
+    return g;
+}
+
+/* ordre topologique des classes (Kahn) : ordre[k] = numéro de classe 1-based,
+   tableau de p->nb entrées à libérer par l'appelant */
+int *ordreTopologiqueClasses(t_partition *p, t_link_array *liens) {
+    int nb = p->nb;
+    int *degre_entrant = (int*)calloc(nb + 1, sizeof(int));
+    int *ordre = (int*)malloc(nb * sizeof(int));
+    if (!degre_entrant || !ordre) { erreurFatale("alloc ordre topologique"); }
+    for (int k = 0; k < liens->size; k++) degre_entrant[liens->links[k].to]++;
+    int debut = 0, fin = 0;
+    /* sources par numéro décroissant : Tarjan numérote les puits en premier */
+    for (int c = nb; c >= 1; c--) {
+        if (degre_entrant[c] == 0) ordre[fin++] = c;
+    }
+    while (debut < fin) {
+        int c = ordre[debut++];
+        for (int k = 0; k < liens->size; k++) {
+            if (liens->links[k].from != c) continue;
+            int d = liens->links[k].to;
+            if (--degre_entrant[d] == 0) ordre[fin++] = d;
+        }
+    }
+    free(degre_entrant);
+    return ordre;
+}
+
+/* degré d'un sommet restreint à sa classe */
+static int degreDansClasse(t_voisinage *g, int *classe_de, int v) {
+    int d = 0;
+    for (int k = g->debut[v]; k < g->debut[v + 1]; k++) {
+        if (classe_de[g->voisins[k]] == classe_de[v]) d++;
+    }
+    return d;
+}
+
+/* ordonne les membres de la classe c par BFS (option : degrés croissants et inversion = RCM).
+ Les sommets ordonnés sont écrits dans sortie[0..size-1]. */
+static void ordonnerClasse(t_voisinage *g, int *classe_de, t_classe *c, int ci, t_ordre ordre,
+                           int *vu, int *degre, int *sortie) {
+    int fin = 0, debut = 0;
+    for (int j = 0; j < c->size; j++) degre[c->members[j]] = degreDansClasse(g, classe_de, c->members[j]);
+    /* départ : sommet de degré minimal (approximation d'un sommet périphérique) */
+    int depart = c->members[0];
+    if (ordre == ORDRE_RCM) {
+        for (int j = 1; j < c->size; j++) {
+            if (degre[c->members[j]] < degre[depart]) depart = c->members[j];
+        }
+    }
+    vu[depart] = 1;
+    sortie[fin++] = depart;
+    while (debut < fin) {
+        int u = sortie[debut++];
+        int premier = fin;
+        for (int k = g->debut[u]; k < g->debut[u + 1]; k++) {
+            int w = g->voisins[k];
+            if (classe_de[w] != ci || vu[w]) continue;
+            vu[w] = 1;
+            sortie[fin++] = w;
+        }
+        if (ordre == ORDRE_RCM) {
+            /* tri par insertion des voisins ajoutés selon le degré croissant */
+            for (int a = premier + 1; a < fin; a++) {
+                int x = sortie[a];
+                int b = a - 1;
+                while (b >= premier && degre[sortie[b]] > degre[x]) {
+                    sortie[b + 1] = sortie[b];
+                    b--;
+                }
+                sortie[b + 1] = x;
+            }
+        }
+    }
+    if (ordre == ORDRE_RCM) {
+        for (int a = 0, b = fin - 1; a < b; a++, b--) {
+            int t = sortie[a];
+            sortie[a] = sortie[b];
+            sortie[b] = t;
+        }
+    }
+}
+
+/* calculerPermutation
+ Construit la renumérotation : classes en ordre topologique (les arêtes entre
+ classes vont toujours vers des numéros plus grands), puis ordre intra-classe
+ selon 'ordre'. 'liens' peut être les liens bruts ou le diagramme de Hasse.
+ */
+t_permutation calculerPermutation(liste_adjacence la, t_partition *p, t_link_array *liens, t_ordre ordre) {
+    int n = la.taille;
+    t_permutation perm;
+    perm.n = n;
+    perm.nouveau_vers_ancien = (int*)malloc((n + 1) * sizeof(int));
+    perm.ancien_vers_nouveau = (int*)malloc((n + 1) * sizeof(int));
+    if (!perm.nouveau_vers_ancien || !perm.ancien_vers_nouveau) {
+        erreurFatale("alloc permutation");
+    }
+    int *classes = ordreTopologiqueClasses(p, liens);
+    int *classe_de = build_vertex_to_class_map(p, n);
+    t_voisinage g;
+    int *vu = NULL, *degre = NULL;
+    if (ordre != ORDRE_CLASSES) {
+        g = construireVoisinage(la);
+        vu = (int*)calloc(n + 1, sizeof(int));
+        degre = (int*)calloc(n + 1, sizeof(int));
+        if (!vu || !degre) { erreurFatale("alloc permutation"); }
+    }
+    int suivant = 1;
+    for (int k = 0; k < p->nb; k++) {
+        int ci = classes[k];
+        t_classe *c = &p->classes[ci - 1];
+        int *sortie = &perm.nouveau_vers_ancien[suivant];
+        if (ordre == ORDRE_CLASSES) {
+            memcpy(sortie, c->members, c->size * sizeof(int));
+        } else {
+            ordonnerClasse(&g, classe_de, c, ci, ordre, vu, degre, sortie);
+        }
+        suivant += c->size;
+    }
+    for (int v = 1; v <= n; v++) {
+        perm.ancien_vers_nouveau[perm.nouveau_vers_ancien[v]] = v;
+    }
+    if (ordre != ORDRE_CLASSES) {
+        free(g.debut);
+        free(g.voisins);
+        free(vu);
+        free(degre);
+    }
+    free(classe_de);
+    free(classes);
+    return perm;
+}
+
+/* arête renumérotée : arrivée et probabilité triées ensemble */
+typedef struct {
+    int arrivee;
+    float proba;
+} t_arc_permute;
+
+static int comparerArcs(const void *a, const void *b) {
+    const t_arc_permute *x = (const t_arc_permute*)a;
+    const t_arc_permute *y = (const t_arc_permute*)b;
+    return (x->arrivee > y->arrivee) - (x->arrivee < y->arrivee);
+}
+
+/* permuterGraphe
+ Renvoie une nouvelle liste d'adjacence renumérotée ; les arêtes de chaque
+ sommet sont triées par arrivée croissante pour un parcours séquentiel
+ (les arêtes multiples sont conservées avec leur propre probabilité).
+ */
+liste_adjacence permuterGraphe(liste_adjacence la, t_permutation *perm) {
+    int n = la.taille;
+    liste_adjacence res = creerListeAdjacence(n);
+    int cap = 16;
+    t_arc_permute *arcs = (t_arc_permute*)malloc(cap * sizeof(t_arc_permute));
+    if (!arcs) { erreurFatale("alloc permuterGraphe"); }
+    for (int nv = 1; nv <= n; nv++) {
+        liste src = la.tab[perm->nouveau_vers_ancien[nv] - 1];
+        int nb = 0;
+        for (cellule *c = src.head; c; c = c->suivant) {
+            if (nb >= cap) {
+                cap *= 2;
+                arcs = (t_arc_permute*)realloc(arcs, cap * sizeof(t_arc_permute));
+                if (!arcs) { erreurFatale("alloc permuterGraphe"); }
+            }
+            arcs[nb].arrivee = perm->ancien_vers_nouveau[c->arrivee];
+            arcs[nb].proba = c->proba;
+            nb++;
+        }
+        qsort(arcs, nb, sizeof(t_arc_permute), comparerArcs);
+        /* insertion en tête : on part de la plus grande arrivée */
+        for (int k = nb - 1; k >= 0; k--) {
+            ajouterCellule(&res.tab[nv - 1], arcs[k].arrivee, arcs[k].proba);
+        }
+    }
+    free(arcs);
+    return res;
+}
+
+/* ordreLocalClasse
+ Les membres d'une classe occupent des numéros consécutifs dans la
+ renumérotation : ordre[r] = indice local (dans c->members) du r-ième
+ membre dans le nouvel ordre. Tableau de c->size entiers, à libérer.
+ */
+int *ordreLocalClasse(t_permutation *perm, t_classe *c) {
+    int *ordre = (int*)malloc((c->size + 1) * sizeof(int));
+    if (!ordre) { erreurFatale("alloc ordreLocalClasse"); }
+    int premier = perm->n + 1;
+    for (int r = 0; r < c->size; r++) {
+        int nv = perm->ancien_vers_nouveau[c->members[r]];
+        if (nv < premier) premier = nv;
+    }
+    for (int r = 0; r < c->size; r++) {
+        ordre[perm->ancien_vers_nouveau[c->members[r]] - premier] = r;
+    }
+    return ordre;
+}
+
+/* permuterCSR
+ Bloc CSR renuméroté : la ligne r du résultat est la ligne ordre[r] de m,
+ colonnes renumérotées de la même façon et triées par ligne.
+ */
+t_csr permuterCSR(t_csr *m, const int *ordre) {
+    t_csr res;
+    res.n = m->n;
+    res.nnz = m->nnz;
+    res.debut = (long*)malloc((m->n + 1) * sizeof(long));
+    res.colonnes = (int*)malloc((m->nnz + 1) * sizeof(int));
+    res.valeurs = (float*)malloc((m->nnz + 1) * sizeof(float));
+    int *inverse = (int*)malloc((m->n + 1) * sizeof(int));
+    t_arc_permute *arcs = (t_arc_permute*)malloc((m->nnz + 1) * sizeof(t_arc_permute));
+    if (!res.debut || !res.colonnes || !res.valeurs || !inverse || !arcs) {
+        erreurFatale("alloc permuterCSR");
+    }
+    for (int r = 0; r < m->n; r++) inverse[ordre[r]] = r;
+    long q = 0;
+    res.debut[0] = 0;
+    for (int r = 0; r < m->n; r++) {
+        int a = ordre[r];
+        long nb = 0;
+        for (long k = m->debut[a]; k < m->debut[a + 1]; k++, nb++) {
+            arcs[nb].arrivee = inverse[m->colonnes[k]];
+            arcs[nb].proba = m->valeurs[k];
+        }
+        qsort(arcs, nb, sizeof(t_arc_permute), comparerArcs);
+        for (long k = 0; k < nb; k++, q++) {
+            res.colonnes[q] = arcs[k].arrivee;
+            res.valeurs[q] = arcs[k].proba;
+        }
+        res.debut[r + 1] = q;
+    }
+    free(arcs);
+    free(inverse);
+    return res;
+}
+
+/* remet un vecteur indexé par les nouveaux numéros dans l'ordre d'origine */
+void vecteurVersOriginal(t_permutation *perm, float *v_permute, float *v_original) {
+    for (int nv = 1; nv <= perm->n; nv++) {
+        v_original[perm->nouveau_vers_ancien[nv] - 1] = v_permute[nv - 1];
+    }
+}
+
+/* range un vecteur indexé par les numéros d'origine dans le nouvel ordre */
+void vecteurVersPermute(t_permutation *perm, float *v_original, float *v_permute) {
+    for (int nv = 1; nv <= perm->n; nv++) {
+        v_permute[nv - 1] = v_original[perm->nouveau_vers_ancien[nv] - 1];
+    }
+}
+
+void libererPermutation(t_permutation *perm) {
+    if (!perm) return;
+    free(perm->nouveau_vers_ancien);
+    free(perm->ancien_vers_nouveau);
+    perm->nouveau_vers_ancien = perm->ancien_vers_nouveau = NULL;
+    perm->n = 0;
+}
+
+/* computeStationaryDistributionOrdonnee
+ Même calcul que computeStationaryDistributionFrom mais sur le graphe
+ renuméroté ; pi est lu et écrit dans la numérotation d'origine.
+ */
+int computeStationaryDistributionOrdonnee(liste_adjacence la, t_partition *p, t_link_array *liens,
+                                          t_ordre ordre, float *pi, float epsilon, int max_iter) {
+    t_permutation perm = calculerPermutation(la, p, liens, ordre);
+    liste_adjacence lp = permuterGraphe(la, &perm);
+    float *pp = createZeroVector(la.taille);
+    vecteurVersPermute(&perm, pi, pp);
+    int it = computeStationaryDistributionFrom(lp, pp, epsilon, max_iter);
+    vecteurVersOriginal(&perm, pp, pi);
+    freeVector(pp);
+    free_liste_adjacence(&lp);
+    libererPermutation(&perm);
+    return it;
+}
@@ -0,0 +1,453 @@
+#include "server.h"
+#include "markov.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <pthread.h>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <afunix.h>
+typedef SOCKET t_socket;
+typedef WSAPOLLFD t_pollfd;
+#define fermerSocket closesocket
+#define poll WSAPoll
+#else
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+typedef int t_socket;
+typedef struct pollfd t_pollfd;
+#define INVALID_SOCKET (-1)
+#define fermerSocket close
+#endif
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+#define TAILLE_LIGNE 1024
+#define EPSILON_SERVEUR 1e-6f
+#define MAX_ITER_SERVEUR 100000
+#define DELAI_ENVOI_S 5     // un client qui ne lit plus ses réponses libère le worker
+
+/* chaîne résidente */
+typedef struct {
+    char nom[64];
+    markov_ctx *ctx;
+} t_chaine;
+
+/* connexion ouverte : surveillée par la boucle poll, ou confiée à un worker */
+typedef struct {
+    t_socket c;              // INVALID_SOCKET : emplacement libre
+    int occupee;             // 1 pendant qu'un worker traite ses requêtes
+    char buf[TAILLE_LIGNE];  // ligne incomplète reçue
+    size_t plein;
+} t_connexion;
+
+/* état partagé du serveur (une instance par appel à lancerServeur) */
+typedef struct {
+    t_chaine chaines[SERVEUR_MAX_CHAINES];
+    int nb_chaines;
+    pthread_rwlock_t verrou_chaines;  // LOAD en écriture, requêtes en lecture
+    const char *dossier_donnees;      // seul dossier accessible à LOAD
+
+    t_connexion connexions[SERVEUR_CONNEXIONS_MAX];
+    int file[SERVEUR_CONNEXIONS_MAX]; // connexions prêtes à lire (chacune au plus une fois)
+    int debut, nb;
+    pthread_mutex_t verrou_file;      // file et champs c/occupee des connexions
+    pthread_cond_t non_vide;
+    t_socket reveil_ecriture;         // un octet : la boucle poll reprend une connexion rendue
+    t_socket reveil_lecture;
+} t_serveur;
+
+/* tampon de réponse extensible */
+typedef struct {
+    char *data;
+    size_t len, cap;
+} t_reponse;
+
+static void reponseAjouter(t_reponse *r, const char *fmt, ...) {
+    for (;;) {
+        va_list ap;
+        va_start(ap, fmt);
+        int k = vsnprintf(r->data + r->len, r->cap - r->len, fmt, ap);
+        va_end(ap);
+        if (k < 0) return;
+        if (r->len + (size_t)k < r->cap) {
+            r->len += k;
+            return;
+        }
+        size_t cap = r->cap * 2 + k;
+        char *d = (char*)realloc(r->data, cap);
+        if (!d) return;
+        r->data = d;
+        r->cap = cap;
+    }
+}
+
+/* cherche une chaîne par nom (verrou tenu par l'appelant) */
+static markov_ctx *trouverChaine(t_serveur *s, const char *nom) {
+    for (int i = 0; i < s->nb_chaines; i++) {
+        if (strcmp(s->chaines[i].nom, nom) == 0) return s->chaines[i].ctx;
+    }
+    return NULL;
+}
+
+/* charge et analyse une chaîne hors verrou, puis l'installe (remplace une chaîne de même nom) */
+static markov_statut chargerChaine(t_serveur *s, const char *nom, const char *fichier, int *n, int *nb_classes) {
+    markov_ctx *ctx;
+    markov_statut st = markov_creer(&ctx);
+    if (st != MARKOV_OK) return st;
+    st = markov_charger_fichier(ctx, fichier);
+    if (st == MARKOV_OK) st = markov_analyser(ctx, EPSILON_SERVEUR, MAX_ITER_SERVEUR);
+    if (st != MARKOV_OK) {
+        markov_detruire(ctx);
+        return st;
+    }
+    *n = markov_nb_etats(ctx);
+    *nb_classes = markov_nb_classes(ctx);
+
+    markov_ctx *ancien = NULL;
+    pthread_rwlock_wrlock(&s->verrou_chaines);
+    int i = 0;
+    while (i < s->nb_chaines && strcmp(s->chaines[i].nom, nom) != 0) i++;
+    if (i < s->nb_chaines) {
+        ancien = s->chaines[i].ctx;
+        s->chaines[i].ctx = ctx;
+    } else if (s->nb_chaines < SERVEUR_MAX_CHAINES) {
+        snprintf(s->chaines[i].nom, sizeof(s->chaines[i].nom), "%s", nom);
+        s->chaines[i].ctx = ctx;
+        s->nb_chaines++;
+    } else {
+        ancien = ctx;
+        st = MARKOV_ERR_ARGUMENT;
+    }
+    pthread_rwlock_unlock(&s->verrou_chaines);
+    markov_detruire(ancien);
+    return st;
+}
+
+/* cheminDonnees
+ LOAD ne lit que dans le dossier de données : chemin relatif, sans
+ composant "..", ni lecteur ou racine. Renvoie 0 et le chemin complet, -1 si refusé.
+ */
+static int cheminDonnees(const t_serveur *s, const char *fichier, char *chemin, size_t taille) {
+    if (!s->dossier_donnees || !fichier[0] || fichier[0] == '/' || fichier[0] == '\\' ||
+        strchr(fichier, ':')) {
+        return -1;
+    }
+    const char *p = fichier;
+    while (*p) {
+        size_t k = strcspn(p, "/\\");
+        if (k == 2 && p[0] == '.' && p[1] == '.') return -1;
+        p += k;
+        if (*p) p++;
+    }
+    int k = snprintf(chemin, taille, "%s/%s", s->dossier_donnees, fichier);
+    return (k < 0 || (size_t)k >= taille) ? -1 : 0;
+}
+
+/* traite une ligne de requête et écrit la réponse (terminée par '\n') dans r */
+static void traiterRequete(t_serveur *s, char *ligne, t_reponse *r) {
+    char cmd[16], nom[64], arg[512];
+    int a = 0, b = 0, k = 0;
+    int nb = sscanf(ligne, "%15s %63s %511s", cmd, nom, arg);
+    if (nb < 1) {
+        reponseAjouter(r, "ERR requête vide\n");
+        return;
+    }
+    if (strcmp(cmd, "PING") == 0) {
+        reponseAjouter(r, "OK\n");
+        return;
+    }
+    if (strcmp(cmd, "LOAD") == 0) {
+        int n, nb_classes;
+        char chemin[1024];
+        if (nb != 3) { reponseAjouter(r, "ERR usage: LOAD <nom> <fichier>\n"); return; }
+        if (cheminDonnees(s, arg, chemin, sizeof(chemin)) != 0) {
+            reponseAjouter(r, "ERR fichier hors du dossier de données\n");
+            return;
+        }
+        markov_statut st = chargerChaine(s, nom, chemin, &n, &nb_classes);
+        if (st != MARKOV_OK) reponseAjouter(r, "ERR %s\n", markov_message(st));
+        else reponseAjouter(r, "OK %d %d\n", n, nb_classes);
+        return;
+    }
+
+    if (strcmp(cmd, "LIST") != 0 && strcmp(cmd, "CLASS") != 0 && strcmp(cmd, "STAT") != 0 &&
+        strcmp(cmd, "DIST") != 0 && strcmp(cmd, "REACH") != 0) {
+        reponseAjouter(r, "ERR commande inconnue\n");
+        return;
+    }
+    pthread_rwlock_rdlock(&s->verrou_chaines);
+    if (strcmp(cmd, "LIST") == 0) {
+        reponseAjouter(r, "OK");
+        for (int i = 0; i < s->nb_chaines; i++) reponseAjouter(r, " %s", s->chaines[i].nom);
+        reponseAjouter(r, "\n");
+        pthread_rwlock_unlock(&s->verrou_chaines);
+        return;
+    }
+    markov_ctx *ctx = nb >= 2 ? trouverChaine(s, nom) : NULL;
+    markov_statut st = MARKOV_OK;
+    if (!ctx) {
+        reponseAjouter(r, "ERR chaîne inconnue\n");
+    } else if (strcmp(cmd, "CLASS") == 0 && sscanf(ligne, "%*s %*s %d", &a) == 1) {
+        int c = 0, pers = 0, per = 0;
+        st = markov_classe_de(ctx, a, &c);
+        if (st == MARKOV_OK) st = markov_classe_persistante(ctx, c, &pers);
+        if (st == MARKOV_OK) st = markov_periode(ctx, c, &per);
+        if (st == MARKOV_OK) reponseAjouter(r, "OK %d %d %d\n", c, pers, per);
+    } else if (strcmp(cmd, "STAT") == 0 && sscanf(ligne, "%*s %*s %d", &a) == 1) {
+        float p = 0.0f;
+        st = markov_stationnaire(ctx, a, &p);
+        if (st == MARKOV_OK) reponseAjouter(r, "OK %.8g\n", p);
+    } else if (strcmp(cmd, "DIST") == 0 && sscanf(ligne, "%*s %*s %d %d", &k, &a) == 2) {
+        int n = markov_nb_etats(ctx);
+        if (a < 1 || a > n || k < 0) {
+            st = MARKOV_ERR_ARGUMENT;
+        } else {
+            float *p = (float*)calloc(n, sizeof(float));
+            if (!p) {
+                st = MARKOV_ERR_MEMOIRE;
+            } else {
+                p[a - 1] = 1.0f;
+                st = markov_distribution_k(ctx, p, k, p);
+                if (st == MARKOV_OK) {
+                    reponseAjouter(r, "OK");
+                    for (int i = 0; i < n; i++) reponseAjouter(r, " %.8g", p[i]);
+                    reponseAjouter(r, "\n");
+                }
+                free(p);
+            }
+        }
+    } else if (strcmp(cmd, "REACH") == 0 && sscanf(ligne, "%*s %*s %d %d", &a, &b) == 2) {
+        int res = 0;
+        st = markov_atteignable(ctx, a, b, &res);
+        if (st == MARKOV_OK) reponseAjouter(r, "OK %d\n", res);
+    } else {
+        reponseAjouter(r, "ERR arguments invalides\n");
+    }
+    if (st != MARKOV_OK) reponseAjouter(r, "ERR %s\n", markov_message(st));
+    pthread_rwlock_unlock(&s->verrou_chaines);
+}
+
+/* envoie tout le tampon ; -1 si le client est parti (EPIPE, sans SIGPIPE) ou ne lit plus */
+static int envoyerTout(t_socket c, const char *data, size_t len) {
+    while (len > 0) {
+        int k = send(c, data, (int)len, MSG_NOSIGNAL);
+        if (k <= 0) return -1;
+        data += k;
+        len -= k;
+    }
+    return 0;
+}
+
+/* servirConnexion
+ Une seule lecture (la boucle poll l'a signalée prête), puis traitement des
+ lignes complètes reçues (requêtes en pipeline) et envoi des réponses.
+ Renvoie 1 si la connexion reste ouverte, 0 s'il faut la fermer.
+ */
+static int servirConnexion(t_serveur *s, t_connexion *cx) {
+    int k = recv(cx->c, cx->buf + cx->plein, (int)(sizeof(cx->buf) - 1 - cx->plein), 0);
+    if (k <= 0) return 0;
+    cx->plein += k;
+    t_reponse r;
+    r.cap = 256;
+    r.len = 0;
+    r.data = (char*)malloc(r.cap);
+    if (!r.data) return 0;
+    size_t debut = 0;
+    for (size_t i = 0; i < cx->plein; i++) {
+        if (cx->buf[i] != '\n') continue;
+        cx->buf[i] = '\0';
+        if (i > debut && cx->buf[i - 1] == '\r') cx->buf[i - 1] = '\0';
+        traiterRequete(s, cx->buf + debut, &r);
+        debut = i + 1;
+    }
+    int garder = 1;
+    if (r.len > 0 && envoyerTout(cx->c, r.data, r.len) != 0) garder = 0;
+    free(r.data);
+    memmove(cx->buf, cx->buf + debut, cx->plein - debut);
+    cx->plein -= debut;
+    if (garder && cx->plein == sizeof(cx->buf) - 1) {
+        /* ligne trop longue : on abandonne la connexion */
+        envoyerTout(cx->c, "ERR ligne trop longue\n", 22);
+        garder = 0;
+    }
+    return garder;
+}
+
+static void *worker(void *arg) {
+    t_serveur *s = (t_serveur*)arg;
+    for (;;) {
+        pthread_mutex_lock(&s->verrou_file);
+        while (s->nb == 0) pthread_cond_wait(&s->non_vide, &s->verrou_file);
+        int i = s->file[s->debut];
+        s->debut = (s->debut + 1) % SERVEUR_CONNEXIONS_MAX;
+        s->nb--;
+        pthread_mutex_unlock(&s->verrou_file);
+
+        t_connexion *cx = &s->connexions[i];
+        int garder = servirConnexion(s, cx);
+
+        /* la connexion retourne à la boucle poll (ou est fermée) */
+        pthread_mutex_lock(&s->verrou_file);
+        if (!garder) {
+            fermerSocket(cx->c);
+            cx->c = INVALID_SOCKET;
+        }
+        cx->occupee = 0;
+        pthread_mutex_unlock(&s->verrou_file);
+        if (garder) send(s->reveil_ecriture, "r", 1, MSG_NOSIGNAL);
+    }
+    return NULL;
+}
+
+/* délai d'envoi : un worker n'attend pas indéfiniment un client qui ne lit plus */
+static void limiterEnvoi(t_socket c) {
+#ifdef _WIN32
+    DWORD ms = DELAI_ENVOI_S * 1000;
+    setsockopt(c, SOL_SOCKET, SO_SNDTIMEO, (const char*)&ms, sizeof(ms));
+#else
+    struct timeval tv;
+    tv.tv_sec = DELAI_ENVOI_S;
+    tv.tv_usec = 0;
+    setsockopt(c, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+#endif
+}
+
+/* lancerServeur
+ Charge les fichiers donnés (nom de chaîne = nom du fichier sans dossier),
+ écoute sur chemin_socket et sert les connexions ouvertes : le thread
+ appelant surveille toutes les connexions inactives (poll) et confie à
+ nb_workers threads chaque connexion qui a des données, le temps d'une
+ lecture et de ses réponses. Un client inactif n'occupe donc aucun worker.
+ LOAD est limité à dossier_donnees. Ne revient qu'en cas d'erreur (renvoie alors -1).
+ */
+int lancerServeur(const char *chemin_socket, int nb_workers, const char *dossier_donnees,
+                  char **fichiers, int nb_fichiers) {
+    t_serveur *s = (t_serveur*)calloc(1, sizeof(t_serveur));
+    if (!s) return -1;
+    pthread_rwlock_init(&s->verrou_chaines, NULL);
+    pthread_mutex_init(&s->verrou_file, NULL);
+    pthread_cond_init(&s->non_vide, NULL);
+    s->dossier_donnees = dossier_donnees;
+    for (int i = 0; i < SERVEUR_CONNEXIONS_MAX; i++) s->connexions[i].c = INVALID_SOCKET;
+#ifndef _WIN32
+    /* un client qui ferme pendant une réponse donne EPIPE au lieu de tuer le serveur */
+    signal(SIGPIPE, SIG_IGN);
+#endif
+
+    for (int i = 0; i < nb_fichiers; i++) {
+        const char *nom = strrchr(fichiers[i], '/');
+        nom = nom ? nom + 1 : fichiers[i];
+        int n, nb_classes;
+        markov_statut st = chargerChaine(s, nom, fichiers[i], &n, &nb_classes);
+        if (st != MARKOV_OK) {
+            fprintf(stderr, "Avertissement: %s : %s\n", fichiers[i], markov_message(st));
+        } else {
+            printf("Chaîne '%s' chargée (%d états, %d classes)\n", nom, n, nb_classes);
+        }
+    }
+
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) return -1;
+#endif
+    struct sockaddr_un adr;
+    memset(&adr, 0, sizeof(adr));
+    adr.sun_family = AF_UNIX;
+    if (strlen(chemin_socket) >= sizeof(adr.sun_path)) {
+        fprintf(stderr, "Chemin de socket trop long\n");
+        return -1;
+    }
+    strcpy(adr.sun_path, chemin_socket);
+    remove(chemin_socket);
+    t_socket ecoute = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (ecoute == INVALID_SOCKET ||
+        bind(ecoute, (struct sockaddr*)&adr, sizeof(adr)) != 0 ||
+        listen(ecoute, 128) != 0) {
+        perror("socket serveur");
+        return -1;
+    }
+    /* canal de réveil de la boucle poll : une connexion du serveur à lui-même */
+    s->reveil_ecriture = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (s->reveil_ecriture == INVALID_SOCKET ||
+        connect(s->reveil_ecriture, (struct sockaddr*)&adr, sizeof(adr)) != 0 ||
+        (s->reveil_lecture = accept(ecoute, NULL, NULL)) == INVALID_SOCKET) {
+        perror("socket de réveil");
+        return -1;
+    }
+
+    if (nb_workers <= 0) nb_workers = SERVEUR_WORKERS_DEFAUT;
+    for (int i = 0; i < nb_workers; i++) {
+        pthread_t t;
+        if (pthread_create(&t, NULL, worker, s) != 0) {
+            perror("pthread_create");
+            return -1;
+        }
+        pthread_detach(t);
+    }
+    printf("Serveur en écoute sur %s (%d workers)\n", chemin_socket, nb_workers);
+    fflush(stdout);
+
+    t_pollfd *fds = (t_pollfd*)malloc((SERVEUR_CONNEXIONS_MAX + 2) * sizeof(t_pollfd));
+    int *indice = (int*)malloc((SERVEUR_CONNEXIONS_MAX + 2) * sizeof(int));
+    if (!fds || !indice) return -1;
+    for (;;) {
+        int nb_fds = 2;
+        fds[0].fd = ecoute;
+        fds[1].fd = s->reveil_lecture;
+        pthread_mutex_lock(&s->verrou_file);
+        for (int i = 0; i < SERVEUR_CONNEXIONS_MAX; i++) {
+            if (s->connexions[i].c == INVALID_SOCKET || s->connexions[i].occupee) continue;
+            fds[nb_fds].fd = s->connexions[i].c;
+            indice[nb_fds++] = i;
+        }
+        pthread_mutex_unlock(&s->verrou_file);
+        for (int k = 0; k < nb_fds; k++) {
+            fds[k].events = POLLIN;
+            fds[k].revents = 0;
+        }
+        if (poll(fds, nb_fds, -1) <= 0) continue;
+
+        if (fds[1].revents & POLLIN) {
+            char tmp[64];
+            recv(s->reveil_lecture, tmp, sizeof(tmp), 0);
+        }
+        pthread_mutex_lock(&s->verrou_file);
+        for (int k = 2; k < nb_fds; k++) {
+            if (!(fds[k].revents & (POLLIN | POLLHUP | POLLERR))) continue;
+            int i = indice[k];
+            s->connexions[i].occupee = 1;
+            s->file[(s->debut + s->nb) % SERVEUR_CONNEXIONS_MAX] = i;
+            s->nb++;
+            pthread_cond_signal(&s->non_vide);
+        }
+        pthread_mutex_unlock(&s->verrou_file);
+
+        if (fds[0].revents & POLLIN) {
+            t_socket c = accept(ecoute, NULL, NULL);
+            if (c == INVALID_SOCKET) continue;
+            limiterEnvoi(c);
+            pthread_mutex_lock(&s->verrou_file);
+            int i = 0;
+            while (i < SERVEUR_CONNEXIONS_MAX && s->connexions[i].c != INVALID_SOCKET) i++;
+            if (i < SERVEUR_CONNEXIONS_MAX) {
+                s->connexions[i].c = c;
+                s->connexions[i].occupee = 0;
+                s->connexions[i].plein = 0;
+            }
+            pthread_mutex_unlock(&s->verrou_file);
+            if (i == SERVEUR_CONNEXIONS_MAX) {
+                envoyerTout(c, "ERR trop de connexions\n", 23);
+                fermerSocket(c);
+            }
+        }
+    }
+    return -1;
+}
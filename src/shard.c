@@ -0,0 +1,338 @@
+#ifndef _WIN32
+#define _GNU_SOURCE   // sched_setaffinity, CPU_SET
+#endif
+#include "shard.h"
+#include "ordonnanceur.h"
+#include <pthread.h>
+
+#ifndef _WIN32
+#include <sched.h>
+#include <signal.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
+
+/* en-tête du segment partagé, suivi des deux vecteurs de n flottants */
+typedef struct {
+    pthread_barrier_t barriere;
+    int n, nb_shards, max_iter;
+    float epsilon;
+    int iterations;                  // écrit par le shard 0
+    int numa;                        // nombre de nœuds NUMA (0 ou 1 : pas d'épinglage)
+    long bornes[SHARD_MAX + 1];
+    float ecarts[2][SHARD_MAX];      // écarts partiels, alternés d'une itération à l'autre
+} t_zone;
+
+#define ZONE_ENTETE ((sizeof(t_zone) + 63) & ~(size_t)63)
+
+static float *vecteurZone(t_zone *z, int v) {
+    return (float*)((char*)z + ZONE_ENTETE) + (size_t)v * z->n;
+}
+
+/* tranche locale de la transposée : arêtes entrantes des états [lo, hi) */
+typedef struct {
+    int lo, hi;
+    long *debut;      // hi - lo + 1 entrées
+    int *sources;     // 0-based
+    float *valeurs;
+} t_tranche;
+
+static void construireTranche(liste_adjacence la, int lo, int hi, t_tranche *t) {
+    int m = hi - lo;
+    t->lo = lo;
+    t->hi = hi;
+    t->debut = (long*)calloc(m + 1, sizeof(long));
+    if (!t->debut) erreurFatale("alloc shard");
+    for (int i = 0; i < la.taille; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) {
+            int j = c->arrivee - 1;
+            if (j >= lo && j < hi) t->debut[j - lo + 1]++;
+        }
+    }
+    for (int r = 0; r < m; r++) t->debut[r + 1] += t->debut[r];
+    long nnz = t->debut[m];
+    t->sources = (int*)malloc((nnz + 1) * sizeof(int));
+    t->valeurs = (float*)malloc((nnz + 1) * sizeof(float));
+    long *pos = (long*)malloc((m + 1) * sizeof(long));
+    if (!t->sources || !t->valeurs || !pos) erreurFatale("alloc shard");
+    memcpy(pos, t->debut, (m + 1) * sizeof(long));
+    for (int i = 0; i < la.taille; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) {
+            int j = c->arrivee - 1;
+            if (j >= lo && j < hi) {
+                t->sources[pos[j - lo]] = i;
+                t->valeurs[pos[j - lo]++] = c->proba;
+            }
+        }
+    }
+    free(pos);
+}
+
+static void libererTranche(t_tranche *t) {
+    free(t->debut);
+    free(t->sources);
+    free(t->valeurs);
+}
+
+/* bornes des tranches : même nombre d'arêtes entrantes (+1 par état) par shard */
+static void decouper(liste_adjacence la, int nb_shards, long *bornes) {
+    int n = la.taille;
+    long *entrants = (long*)calloc(n, sizeof(long));
+    if (!entrants) erreurFatale("alloc shard");
+    long total = 0;
+    for (int i = 0; i < n; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) entrants[c->arrivee - 1]++;
+    }
+    for (int j = 0; j < n; j++) total += entrants[j] + 1;
+    long cumul = 0;
+    int k = 1;
+    bornes[0] = 0;
+    for (int j = 0; j < n && k < nb_shards; j++) {
+        cumul += entrants[j] + 1;
+        while (k < nb_shards && cumul >= total * k / nb_shards) bornes[k++] = j + 1;
+    }
+    while (k <= nb_shards) bornes[k++] = n;
+    free(entrants);
+}
+
+#ifndef _WIN32
+/* nombre de nœuds NUMA d'après /sys (1 si l'information est absente) */
+static int nombreNoeudsNuma(void) {
+    int nb = 0;
+    char chemin[64];
+    for (;;) {
+        snprintf(chemin, sizeof(chemin), "/sys/devices/system/node/node%d", nb);
+        if (access(chemin, F_OK) != 0) break;
+        nb++;
+    }
+    return nb > 0 ? nb : 1;
+}
+
+/* épingle le processus courant sur les cœurs du nœud (liste "0-3,8-11") */
+static void epinglerNoeud(int noeud) {
+    char chemin[80], liste[1024];
+    snprintf(chemin, sizeof(chemin), "/sys/devices/system/node/node%d/cpulist", noeud);
+    FILE *f = fopen(chemin, "r");
+    if (!f) return;
+    if (!fgets(liste, sizeof(liste), f)) liste[0] = '\0';
+    fclose(f);
+    cpu_set_t ens;
+    CPU_ZERO(&ens);
+    int vide = 1;
+    for (char *p = liste; *p && *p != '\n';) {
+        char *fin;
+        long a = strtol(p, &fin, 10), b = a;
+        if (fin == p) break;
+        if (*fin == '-') b = strtol(fin + 1, &fin, 10);
+        for (long c = a; c <= b && c < CPU_SETSIZE; c++) {
+            CPU_SET((int)c, &ens);
+            vide = 0;
+        }
+        p = (*fin == ',') ? fin + 1 : fin;
+    }
+    if (!vide) sched_setaffinity(0, sizeof(ens), &ens);
+}
+#endif
+
+/* travail d'un shard : construction de sa tranche puis itérations synchronisées */
+static void executerShard(t_zone *z, liste_adjacence la, const float *depart, int k) {
+#ifndef _WIN32
+    if (z->numa > 1) epinglerNoeud(k % z->numa);
+#endif
+    int lo = (int)z->bornes[k], hi = (int)z->bornes[k + 1];
+    t_tranche t;
+    construireTranche(la, lo, hi, &t);
+    float *v[2] = { vecteurZone(z, 0), vecteurZone(z, 1) };
+    /* premier contact avec nos pages des vecteurs partagés depuis notre nœud */
+    for (int j = lo; j < hi; j++) {
+        v[0][j] = depart[j];
+        v[1][j] = 0.0f;
+    }
+    pthread_barrier_wait(&z->barriere);
+
+    int cur = 0, iter = 0;
+    while (iter < z->max_iter) {
+        const float *p = v[cur];
+        float *q = v[cur ^ 1];
+        float d = 0.0f;
+        for (int j = lo; j < hi; j++) {
+            float s = 0.0f;
+            for (long e = t.debut[j - lo]; e < t.debut[j - lo + 1]; e++) {
+                s += p[t.sources[e]] * t.valeurs[e];
+            }
+            q[j] = s;
+            d += fabsf(s - p[j]);
+        }
+        z->ecarts[iter & 1][k] = d;
+        pthread_barrier_wait(&z->barriere);
+        float total = 0.0f;
+        for (int s = 0; s < z->nb_shards; s++) total += z->ecarts[iter & 1][s];
+        cur ^= 1;
+        iter++;
+        if (total < z->epsilon) break;
+    }
+    if (k == 0) {
+        z->iterations = iter;
+        /* le résultat doit être dans le vecteur 0 */
+        if (cur == 1) memcpy(v[0], v[1], (size_t)z->n * sizeof(float));
+    }
+    libererTranche(&t);
+}
+
+#ifdef _WIN32
+typedef struct {
+    t_zone *z;
+    liste_adjacence la;
+    const float *depart;
+    int k;
+} t_arg_shard;
+
+static void *threadShard(void *arg) {
+    t_arg_shard *a = (t_arg_shard*)arg;
+    executerShard(a->z, a->la, a->depart, a->k);
+    return NULL;
+}
+#endif
+
+/* stationnaireShards
+ Même itération que computeStationaryDistributionFrom (pi <- pi * P, arrêt quand
+ la norme L1 de l'écart passe sous epsilon) répartie sur nb_shards processus
+ (nb_shards <= 0 : un par cœur). pi sert de point de départ s'il est non nul,
+ sinon on part de la loi uniforme. Renvoie le nombre d'itérations, -1 en cas
+ d'erreur (segment partagé, fork ou shard terminé anormalement : les autres
+ shards sont alors tués).
+ */
+int stationnaireShards(liste_adjacence la, float *pi, int nb_shards, float epsilon, int max_iter) {
+    int n = la.taille;
+    if (nb_shards <= 0) nb_shards = nombreCoeurs();
+    if (nb_shards > SHARD_MAX) nb_shards = SHARD_MAX;
+    if (nb_shards > n) nb_shards = n;
+    float masse = 0.0f;
+    for (int i = 0; i < n; i++) masse += pi[i];
+    if (masse == 0.0f) {
+        for (int i = 0; i < n; i++) pi[i] = 1.0f / n;
+    }
+    size_t taille = ZONE_ENTETE + 2 * (size_t)n * sizeof(float);
+
+#ifdef _WIN32
+    t_zone *z = (t_zone*)malloc(taille);
+    if (!z) erreurFatale("alloc shard");
+#else
+    char nom[64];
+    snprintf(nom, sizeof(nom), "/markov_shards_%ld", (long)getpid());
+    int fd = shm_open(nom, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) return -1;
+    /* le nom n'est plus utile une fois le segment projeté : les shards en héritent */
+    shm_unlink(nom);
+    if (ftruncate(fd, (off_t)taille) != 0) {
+        close(fd);
+        return -1;
+    }
+    t_zone *z = (t_zone*)mmap(NULL, taille, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (z == MAP_FAILED) return -1;
+#endif
+    z->n = n;
+    z->nb_shards = nb_shards;
+    z->max_iter = max_iter;
+    z->epsilon = epsilon;
+    z->iterations = -1;
+    decouper(la, nb_shards, z->bornes);
+    pthread_barrierattr_t attr;
+    pthread_barrierattr_init(&attr);
+#ifdef _WIN32
+    z->numa = 1;
+#else
+    z->numa = nombreNoeudsNuma();
+    pthread_barrierattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+#endif
+    pthread_barrier_init(&z->barriere, &attr, nb_shards);
+    pthread_barrierattr_destroy(&attr);
+
+    int ok = 1;
+#ifdef _WIN32
+    pthread_t *threads = (pthread_t*)malloc(nb_shards * sizeof(pthread_t));
+    t_arg_shard *args = (t_arg_shard*)malloc(nb_shards * sizeof(t_arg_shard));
+    if (!threads || !args) erreurFatale("alloc shard");
+    for (int k = 0; k < nb_shards; k++) {
+        args[k].z = z;
+        args[k].la = la;
+        args[k].depart = pi;
+        args[k].k = k;
+        if (pthread_create(&threads[k], NULL, threadShard, &args[k]) != 0) {
+            erreurFatale("creation shard");
+        }
+    }
+    for (int k = 0; k < nb_shards; k++) pthread_join(threads[k], NULL);
+    free(threads);
+    free(args);
+#else
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pids[SHARD_MAX];
+    int lances = 0;
+    for (int k = 0; k < nb_shards; k++) {
+        pids[k] = fork();
+        if (pids[k] == 0) {
+            /* le point de reprise et le registre hérités appartiennent au parent :
+               une erreur dans le shard termine le fils par _exit, sans retour
+               dans le code du parent ni gestionnaires atexit */
+            jmp_buf reprise;
+            definirRessources(NULL);
+            definirPointReprise(&reprise);
+            if (setjmp(reprise) == 0) {
+                executerShard(z, la, pi, k);
+                _exit(0);
+            }
+            _exit(EXIT_FAILURE);
+        }
+        if (pids[k] < 0) {
+            /* les shards déjà lancés attendraient indéfiniment à la barrière */
+            for (int s = 0; s < lances; s++) kill(pids[s], SIGKILL);
+            ok = 0;
+            break;
+        }
+        lances++;
+    }
+    /* shards récoltés dans l'ordre de fin : au premier arrêt anormal, les
+       autres, bloqués à la barrière, sont tués */
+    int restants = lances;
+    while (restants > 0) {
+        int statut;
+        pid_t p = waitpid(-1, &statut, 0);
+        if (p < 0) {
+            if (errno == EINTR) continue;
+            ok = 0;
+            break;
+        }
+        int k = 0;
+        while (k < lances && pids[k] != p) k++;
+        if (k == lances) continue;   // pas un shard
+        pids[k] = 0;
+        restants--;
+        if (!WIFEXITED(statut) || WEXITSTATUS(statut) != 0) {
+            if (ok) {
+                for (int s = 0; s < lances; s++) {
+                    if (pids[s] > 0) kill(pids[s], SIGKILL);
+                }
+            }
+            ok = 0;
+        }
+    }
+#endif
+
+    int iter = ok ? z->iterations : -1;
+    if (iter >= 0) memcpy(pi, vecteurZone(z, 0), (size_t)n * sizeof(float));
+    /* après un shard tué à la barrière, la détruire attendrait indéfiniment
+       ses participants : le segment est simplement libéré */
+    if (ok) pthread_barrier_destroy(&z->barriere);
+#ifdef _WIN32
+    free(z);
+#else
+    munmap(z, taille);
+#endif
+    return iter;
+}
@@ -0,0 +1,203 @@
+#include "sparse.h"
+#include "matrix.h"
+
+typedef struct {
+    int colonne;
+    float valeur;
+} t_entree;
+
+static int comparerEntrees(const void *a, const void *b) {
+    const t_entree *x = (const t_entree*)a;
+    const t_entree *y = (const t_entree*)b;
+    return (x->colonne > y->colonne) - (x->colonne < y->colonne);
+}
+
+/* construit la CSR (lignes triées par colonne) depuis la liste d'adjacence */
+t_csr csrDepuisAdjacence(liste_adjacence la) {
+    t_csr m;
+    m.n = la.taille;
+    m.debut = (long*)malloc((m.n + 1) * sizeof(long));
+    if (!m.debut) erreurFatale("alloc csr");
+    m.debut[0] = 0;
+    for (int i = 0; i < m.n; i++) {
+        long deg = 0;
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) deg++;
+        m.debut[i + 1] = m.debut[i] + deg;
+    }
+    m.nnz = m.debut[m.n];
+    m.colonnes = (int*)malloc((m.nnz + 1) * sizeof(int));
+    m.valeurs = (float*)malloc((m.nnz + 1) * sizeof(float));
+    t_entree *tmp = (t_entree*)malloc((m.nnz + 1) * sizeof(t_entree));
+    if (!m.colonnes || !m.valeurs || !tmp) erreurFatale("alloc csr");
+    for (int i = 0; i < m.n; i++) {
+        long k = m.debut[i];
+        for (cellule *c = la.tab[i].head; c; c = c->suivant, k++) {
+            tmp[k].colonne = c->arrivee - 1;
+            tmp[k].valeur = c->proba;
+        }
+        qsort(tmp + m.debut[i], m.debut[i + 1] - m.debut[i], sizeof(t_entree), comparerEntrees);
+    }
+    for (long k = 0; k < m.nnz; k++) {
+        m.colonnes[k] = tmp[k].colonne;
+        m.valeurs[k] = tmp[k].valeur;
+    }
+    free(tmp);
+    return m;
+}
+
+/* out = vec * M (vecteur ligne) */
+void multiplyVectorCSR(float *vec, t_csr *m, float *out) {
+    for (int j = 0; j < m->n; j++) out[j] = 0.0f;
+    for (int i = 0; i < m->n; i++) {
+        float vi = vec[i];
+        if (vi == 0.0f) continue;
+        for (long k = m->debut[i]; k < m->debut[i + 1]; k++) {
+            out[m->colonnes[k]] += vi * m->valeurs[k];
+        }
+    }
+}
+
+/* transposée de m (CSR de la matrice transposée) : les lignes restent triées,
+   les entrées d'une ligne j rangées par ligne d'origine croissante */
+t_csr transposerCSR(t_csr *m) {
+    t_csr t;
+    t.n = m->n;
+    t.nnz = m->nnz;
+    t.debut = (long*)calloc(m->n + 1, sizeof(long));
+    t.colonnes = (int*)malloc((m->nnz + 1) * sizeof(int));
+    t.valeurs = (float*)malloc((m->nnz + 1) * sizeof(float));
+    long *pos = (long*)malloc((m->n + 1) * sizeof(long));
+    if (!t.debut || !t.colonnes || !t.valeurs || !pos) erreurFatale("alloc transposee");
+    for (long k = 0; k < m->nnz; k++) t.debut[m->colonnes[k] + 1]++;
+    for (int j = 0; j < m->n; j++) t.debut[j + 1] += t.debut[j];
+    memcpy(pos, t.debut, (m->n + 1) * sizeof(long));
+    for (int i = 0; i < m->n; i++) {
+        for (long k = m->debut[i]; k < m->debut[i + 1]; k++) {
+            long q = pos[m->colonnes[k]]++;
+            t.colonnes[q] = i;
+            t.valeurs[q] = m->valeurs[k];
+        }
+    }
+    free(pos);
+    return t;
+}
+
+/* fonction de libération pour suivreRessource */
+void ressourceCSR(void *m) {
+    libererCSR((t_csr*)m);
+}
+
+void libererCSR(t_csr *m) {
+    if (!m) return;
+    free(m->debut);
+    free(m->colonnes);
+    free(m->valeurs);
+    m->debut = NULL;
+    m->colonnes = NULL;
+    m->valeurs = NULL;
+    m->n = 0;
+    m->nnz = 0;
+}
+
+/* extraireSousChaines
+ Toutes les sous-chaînes par classe en un seul parcours des arêtes : chaque
+ sommet reçoit son indice local (position dans members), les arêtes internes
+ sont comptées par ligne puis rangées dans le bloc CSR de leur classe.
+ Coût O(n + m) au total, au lieu d'une matrice dense size x size par classe.
+ */
+t_csr *extraireSousChaines(liste_adjacence la, t_partition *part, int *vertex_to_class) {
+    int n = la.taille;
+    int *local = (int*)malloc((n + 1) * sizeof(int));
+    t_csr *blocs = (t_csr*)malloc((part->nb + 1) * sizeof(t_csr));
+    if (!local || !blocs) erreurFatale("alloc sous-chaines");
+    for (int c = 0; c < part->nb; c++) {
+        t_classe *cl = &part->classes[c];
+        for (int r = 0; r < cl->size; r++) local[cl->members[r]] = r;
+        blocs[c].n = cl->size;
+        blocs[c].debut = (long*)calloc(cl->size + 1, sizeof(long));
+        if (!blocs[c].debut) erreurFatale("alloc sous-chaines");
+    }
+    /* degrés internes, puis décalages */
+    for (int u = 1; u <= n; u++) {
+        int c = vertex_to_class[u] - 1;
+        for (cellule *e = la.tab[u - 1].head; e; e = e->suivant) {
+            if (vertex_to_class[e->arrivee] == c + 1) blocs[c].debut[local[u] + 1]++;
+        }
+    }
+    long deg_max = 0;  // lignes internes les plus longues (doublons compris)
+    for (int c = 0; c < part->nb; c++) {
+        t_csr *b = &blocs[c];
+        for (int r = 0; r < b->n; r++) {
+            if (b->debut[r + 1] > deg_max) deg_max = b->debut[r + 1];
+            b->debut[r + 1] += b->debut[r];
+        }
+        b->nnz = b->debut[b->n];
+        b->colonnes = (int*)malloc((b->nnz + 1) * sizeof(int));
+        b->valeurs = (float*)malloc((b->nnz + 1) * sizeof(float));
+        if (!b->colonnes || !b->valeurs) erreurFatale("alloc sous-chaines");
+    }
+    /* remplissage, puis tri des lignes par colonne */
+    t_entree *tmp = (t_entree*)malloc((deg_max + 1) * sizeof(t_entree));
+    if (!tmp) erreurFatale("alloc sous-chaines");
+    for (int u = 1; u <= n; u++) {
+        int c = vertex_to_class[u] - 1;
+        t_csr *b = &blocs[c];
+        long k0 = b->debut[local[u]];
+        long deg = 0;
+        for (cellule *e = la.tab[u - 1].head; e; e = e->suivant) {
+            if (vertex_to_class[e->arrivee] != c + 1) continue;
+            tmp[deg].colonne = local[e->arrivee];
+            tmp[deg].valeur = e->proba;
+            deg++;
+        }
+        qsort(tmp, deg, sizeof(t_entree), comparerEntrees);
+        for (long d = 0; d < deg; d++) {
+            b->colonnes[k0 + d] = tmp[d].colonne;
+            b->valeurs[k0 + d] = tmp[d].valeur;
+        }
+    }
+    free(tmp);
+    free(local);
+    return blocs;
+}
+
+void libererSousChaines(t_csr *blocs, int nb) {
+    if (!blocs) return;
+    for (int c = 0; c < nb; c++) libererCSR(&blocs[c]);
+    free(blocs);
+}
+
+/* période d'un bloc fortement connexe (même calcul que getPeriodAdjacency) */
+int periodeCSR(t_csr *m) {
+    if (m->n == 0) return 0;
+    int *niveau = (int*)malloc(m->n * sizeof(int));
+    int *file = (int*)malloc(m->n * sizeof(int));
+    if (!niveau || !file) erreurFatale("alloc periodeCSR");
+    for (int i = 0; i < m->n; i++) niveau[i] = -1;
+    int debut = 0, fin = 0, period = 0;
+    niveau[0] = 0;
+    file[fin++] = 0;
+    while (debut < fin) {
+        int u = file[debut++];
+        for (long k = m->debut[u]; k < m->debut[u + 1]; k++) {
+            int v = m->colonnes[k];
+            if (m->valeurs[k] <= 0.0f) continue;
+            if (niveau[v] == -1) {
+                niveau[v] = niveau[u] + 1;
+                file[fin++] = v;
+            } else {
+                int vals[2] = { period, abs(niveau[u] + 1 - niveau[v]) };
+                period = gcd(vals, 2);
+            }
+        }
+    }
+    free(niveau);
+    free(file);
+    return period;
+}
+
+float sommeLigneCSR(t_csr *m, int i) {
+    float s = 0.0f;
+    for (long k = m->debut[i]; k < m->debut[i + 1]; k++) s += m->valeurs[k];
+    return s;
+}
@@ -0,0 +1,104 @@
+#include "spectral.h"
+
+/* nombre d'itérations k tel que lambda^k < epsilon, -1 si lambda ~ 1 (pas de convergence) */
+int iterationsEstimees(float lambda, float epsilon) {
+    if (lambda >= 0.9999f) return -1;
+    if (lambda <= 1e-6f) return 1;
+    double k = log((double)epsilon) / log((double)lambda);
+    return (int)ceil(k) + 1;
+}
+
+/* itérations attendues avec marge (x4 sur l'estimation), sans dépasser le
+ plafond ; sans estimation (lambda ~ 1, classe périodique), le plafond. Sert
+ à évaluer le travail d'une résolution, pas à l'arrêter. */
+int borneIterations(int estimation, int plafond) {
+    if (estimation < 0) return plafond;
+    long b = 4L * estimation + 50;
+    return b < plafond ? (int)b : plafond;
+}
+
+/* out = x * S où S est la restriction de P à la classe (indices locaux) */
+static void produitClasse(liste_adjacence la, t_classe *c, int ci, int *vertex_to_class,
+                          int *local, float *x, float *out) {
+    for (int k = 0; k < c->size; k++) out[k] = 0.0f;
+    for (int k = 0; k < c->size; k++) {
+        if (x[k] == 0.0f) continue;
+        cellule *tmp = la.tab[c->members[k] - 1].head;
+        while (tmp) {
+            if (vertex_to_class[tmp->arrivee] == ci) {
+                out[local[tmp->arrivee]] += x[k] * tmp->proba;
+            }
+            tmp = tmp->suivant;
+        }
+    }
+}
+
+/* estimerSpectreClasse
+ Quelques itérations de puissance sur l'opérateur creux de la classe.
+ À chaque pas on normalise (norme L1) et on mémorise le log du facteur de
+ contraction ; la moyenne sur la seconde moitié des pas donne lambda
+ (la moyenne géométrique lisse les oscillations dues aux valeurs propres
+ complexes). Coût : nb_iter parcours des arêtes de la classe.
+ */
+t_spectre estimerSpectreClasse(liste_adjacence la, t_partition *p, int *vertex_to_class,
+                               int compo_index, float epsilon, int nb_iter) {
+    t_classe *c = &p->classes[compo_index];
+    int ci = compo_index + 1;
+    int m = c->size;
+    t_spectre s;
+    s.fermee = 1;
+    for (int k = 0; k < m && s.fermee; k++) {
+        for (cellule *tmp = la.tab[c->members[k] - 1].head; tmp; tmp = tmp->suivant) {
+            if (vertex_to_class[tmp->arrivee] != ci) { s.fermee = 0; break; }
+        }
+    }
+
+    int *local = (int*)malloc((la.taille + 1) * sizeof(int));
+    float *x = (float*)malloc(m * sizeof(float));
+    float *y = (float*)malloc(m * sizeof(float));
+    if (!local || !x || !y) { erreurFatale("alloc estimerSpectreClasse"); }
+    for (int k = 0; k < m; k++) local[c->members[k]] = k;
+
+    /* vecteur de départ pseudo-aléatoire (générateur congruentiel, reproductible) */
+    unsigned int graine = 12345u;
+    for (int k = 0; k < m; k++) {
+        graine = graine * 1103515245u + 12345u;
+        x[k] = (float)((graine >> 16) & 0x7fff) / 32768.0f + (s.fermee ? 0.0f : 1.0f);
+    }
+
+    double somme_log = 0.0;
+    int nb_log = 0;
+    int nul = 0;
+    for (int it = 0; it < nb_iter && !nul; it++) {
+        if (s.fermee) {
+            /* projection sur {somme = 0} : enlève la composante de la valeur propre 1 */
+            float moy = 0.0f;
+            for (int k = 0; k < m; k++) moy += x[k];
+            moy /= m;
+            for (int k = 0; k < m; k++) x[k] -= moy;
+        }
+        float norme = 0.0f;
+        for (int k = 0; k < m; k++) norme += fabsf(x[k]);
+        if (norme < 1e-30f) { nul = 1; break; }
+        for (int k = 0; k < m; k++) x[k] /= norme;
+        produitClasse(la, c, ci, vertex_to_class, local, x, y);
+        float ny = 0.0f;
+        for (int k = 0; k < m; k++) ny += fabsf(y[k]);
+        if (ny < 1e-30f) { nul = 1; break; }
+        if (it >= nb_iter / 2) {
+            somme_log += log((double)ny);
+            nb_log++;
+        }
+        float *t = x; x = y; y = t;
+    }
+    /* opérateur nilpotent ou sous-espace trivial (classe de taille 1 fermée) : convergence immédiate */
+    s.lambda = (nul || nb_log == 0) ? 0.0f : (float)exp(somme_log / nb_log);
+    if (s.lambda > 1.0f) s.lambda = 1.0f;
+    s.iterations_estimees = iterationsEstimees(s.lambda, epsilon);
+    s.temps_melange = s.lambda >= 0.9999f ? -1.0f : 1.0f / (1.0f - s.lambda);
+
+    free(local);
+    free(x);
+    free(y);
+    return s;
+}
@@ -0,0 +1,156 @@
+#include "spmv.h"
+
+/* tranches contiguës d'arrivées, de même nombre d'arêtes entrantes */
+static t_spmv spmvDepuisTransposee(t_csr tr, t_ordonnanceur *o) {
+    t_spmv s;
+    s.transposee = tr;
+    long nb = tr.nnz / SPMV_ARETES_TRANCHE;
+    if (nb > SPMV_TRANCHES_MAX) nb = SPMV_TRANCHES_MAX;
+    if (nb > tr.n) nb = tr.n;
+    if (nb < 1) nb = 1;
+    s.nb_tranches = (int)nb;
+    suivreRessource(&s.transposee, ressourceCSR);
+    s.bornes = (int*)malloc((nb + 1) * sizeof(int));
+    if (!s.bornes) erreurFatale("alloc tranches spmv");
+    oublierRessource(&s.transposee);
+    int j = 0;
+    s.bornes[0] = 0;
+    for (int t = 0; t < s.nb_tranches; t++) {
+        long cible = (tr.nnz * (t + 1)) / nb;
+        while (j < tr.n && (tr.debut[j] < cible || t == s.nb_tranches - 1)) j++;
+        s.bornes[t + 1] = j;
+    }
+    s.o = (o && s.nb_tranches > 1 && tr.nnz >= SPMV_SEUIL_PARALLELE) ? o : NULL;
+    return s;
+}
+
+/* depuis la CSR de P (lignes = départs) */
+t_spmv creerSpmv(t_csr *m, t_ordonnanceur *o) {
+    return spmvDepuisTransposee(transposerCSR(m), o);
+}
+
+/* transposée construite directement depuis la liste d'adjacence (sans CSR intermédiaire) */
+t_spmv creerSpmvAdjacence(liste_adjacence la, t_ordonnanceur *o) {
+    t_csr t;
+    int n = la.taille;
+    t.n = n;
+    t.debut = (long*)calloc(n + 1, sizeof(long));
+    if (!t.debut) erreurFatale("alloc transposee");
+    t.colonnes = NULL;
+    t.valeurs = NULL;
+    suivreRessource(&t, ressourceCSR);
+    for (int i = 0; i < n; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) t.debut[c->arrivee]++;
+    }
+    for (int j = 0; j < n; j++) t.debut[j + 1] += t.debut[j];
+    t.nnz = t.debut[n];
+    t.colonnes = (int*)malloc((t.nnz + 1) * sizeof(int));
+    t.valeurs = (float*)malloc((t.nnz + 1) * sizeof(float));
+    long *pos = (long*)malloc((n + 1) * sizeof(long));
+    if (!t.colonnes || !t.valeurs || !pos) {
+        free(pos);
+        erreurFatale("alloc transposee");
+    }
+    memcpy(pos, t.debut, (n + 1) * sizeof(long));
+    for (int i = 0; i < n; i++) {
+        for (cellule *c = la.tab[i].head; c; c = c->suivant) {
+            long q = pos[c->arrivee - 1]++;
+            t.colonnes[q] = i;
+            t.valeurs[q] = c->proba;
+        }
+    }
+    free(pos);
+    oublierRessource(&t);
+    return spmvDepuisTransposee(t, o);
+}
+
+/* tâche : une tranche du produit, écart partiel dans diff */
+typedef struct {
+    const t_spmv *s;
+    const void *vec;
+    void *out;
+    int tranche;
+    double diff;
+} t_tache_spmv;
+
+/*
+   DEFINIR_SPMV(T, S) : produit tiré out = vec * P pour le type T, fonctions
+   suffixées par S ; renvoie l'écart L1 entre vec et out (vec != out).
+   Les sommes par arrivée parcourent les départs dans l'ordre croissant, comme
+   le produit poussé de precision.c : mêmes arrondis, même résultat.
+*/
+#define DEFINIR_SPMV(T, S)                                                            \
+static T tranche_##S(const t_spmv *s, const T *vec, T *out, int t) {                  \
+    const t_csr *m = &s->transposee;                                                  \
+    T d = 0;                                                                          \
+    for (int j = s->bornes[t]; j < s->bornes[t + 1]; j++) {                           \
+        T x = 0;                                                                      \
+        for (long k = m->debut[j]; k < m->debut[j + 1]; k++) {                        \
+            x += vec[m->colonnes[k]] * (T)m->valeurs[k];                              \
+        }                                                                             \
+        out[j] = x;                                                                   \
+        d += vec[j] > x ? vec[j] - x : x - vec[j];                                    \
+    }                                                                                 \
+    return d;                                                                         \
+}                                                                                     \
+                                                                                      \
+static void tacheSpmv_##S(void *arg) {                                                \
+    t_tache_spmv *t = (t_tache_spmv*)arg;                                             \
+    t->diff = tranche_##S(t->s, (const T*)t->vec, (T*)t->out, t->tranche);            \
+}                                                                                     \
+                                                                                      \
+T multiplierSpmv_##S(const t_spmv *s, const T *vec, T *out) {                         \
+    T d = 0;                                                                          \
+    if (!s->o) {                                                                      \
+        for (int t = 0; t < s->nb_tranches; t++) d += tranche_##S(s, vec, out, t);    \
+        return d;                                                                     \
+    }                                                                                 \
+    t_tache_spmv *taches =                                                            \
+        (t_tache_spmv*)malloc(s->nb_tranches * sizeof(t_tache_spmv));                 \
+    if (!taches) erreurFatale("alloc taches spmv");                                   \
+    t_groupe g;                                                                       \
+    initGroupe(&g);                                                                   \
+    for (int t = 0; t < s->nb_tranches; t++) {                                        \
+        taches[t].s = s;                                                              \
+        taches[t].vec = vec;                                                          \
+        taches[t].out = out;                                                          \
+        taches[t].tranche = t;                                                        \
+        taches[t].diff = 0;                                                           \
+        if (s->bornes[t + 1] > s->bornes[t]) {                                        \
+            soumettreTache(s->o, &g, tacheSpmv_##S, &taches[t]);                      \
+        }                                                                             \
+    }                                                                                 \
+    attendreGroupe(s->o, &g);                                                         \
+    for (int t = 0; t < s->nb_tranches; t++) d += (T)taches[t].diff;                  \
+    free(taches);                                                                     \
+    return d;                                                                         \
+}
+
+DEFINIR_SPMV(float, f)
+DEFINIR_SPMV(double, d)
+
+/* p <- p * P^k (en float, comme multiplyVectorAdjacency) */
+void etapesSpmv(const t_spmv *s, float *p, int k) {
+    int n = s->transposee.n;
+    if (k <= 0 || n == 0) return;
+    float *tmp = (float*)malloc(n * sizeof(float));
+    if (!tmp) erreurFatale("alloc etapes spmv");
+    suivreRessource(tmp, free);
+    float *cur = p, *next = tmp;
+    for (int t = 0; t < k; t++) {
+        multiplierSpmv_f(s, cur, next);
+        float *x = cur; cur = next; next = x;
+    }
+    if (cur != p) memcpy(p, cur, n * sizeof(float));
+    oublierRessource(tmp);
+    free(tmp);
+}
+
+void libererSpmv(t_spmv *s) {
+    if (!s) return;
+    libererCSR(&s->transposee);
+    free(s->bornes);
+    s->bornes = NULL;
+    s->nb_tranches = 0;
+    s->o = NULL;
+}
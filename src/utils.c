@@ -1,33 +1,124 @@
 #include "graph.h"
+#include "ecriture.h"
 
 /* 
     Partie 1 : utilitaires
 */
 
-/*retourne un identifiant lisible pour le sommet (A, B, ..., AA...). */
-char* getId(int num) {
-    static char id[8];
-    id[0] = '\0';
+/* point de reprise du thread courant pour erreurFatale (NULL : comportement historique) */
+static _Thread_local jmp_buf *point_reprise = NULL;
+
+/* registre des ressources en cours de construction du thread courant (NULL : aucun) */
+static _Thread_local t_ressources *ressources_courantes = NULL;
+
+/* erreur non récupérable (allocation...) : retour au point de reprise s'il existe
+ (utilisé par la bibliothèque, cf. markov.h), après libération des ressources
+ suivies ; sinon message et fin du programme. */
+void erreurFatale(const char *msg) {
+    if (point_reprise) {
+        t_ressources *r = ressources_courantes;
+        while (r && r->nb > 0) {
+            r->nb--;
+            r->liberer[r->nb](r->ptr[r->nb]);
+        }
+        longjmp(*point_reprise, 1);
+    }
+    perror(msg);
+    exit(EXIT_FAILURE);
+}
+
+/* installe (ou retire avec NULL) le point de reprise du thread courant, renvoie l'ancien. */
+jmp_buf *definirPointReprise(jmp_buf *j) {
+    jmp_buf *ancien = point_reprise;
+    point_reprise = j;
+    return ancien;
+}
+
+/* installe (ou retire avec NULL) le registre de ressources du thread courant, renvoie l'ancien. */
+t_ressources *definirRessources(t_ressources *r) {
+    t_ressources *ancien = ressources_courantes;
+    if (r) r->nb = 0;
+    ressources_courantes = r;
+    return ancien;
+}
+
+/* ptr sera libéré par liberer(ptr) si erreurFatale revient au point de reprise.
+ Les pointeurs vers des variables locales sont valides : la libération a lieu
+ avant le longjmp, pendant que la pile de l'appelant existe encore. */
+void suivreRessource(void *ptr, void (*liberer)(void *)) {
+    t_ressources *r = ressources_courantes;
+    if (!r || !ptr || r->nb >= RESSOURCES_MAX) return;
+    r->ptr[r->nb] = ptr;
+    r->liberer[r->nb] = liberer;
+    r->nb++;
+}
+
+/* retire ptr du registre (la ressource est rendue ou transmise à l'appelant) */
+void oublierRessource(void *ptr) {
+    t_ressources *r = ressources_courantes;
+    if (!r) return;
+    for (int k = r->nb - 1; k >= 0; k--) {
+        if (r->ptr[k] != ptr) continue;
+        for (int j = k; j < r->nb - 1; j++) {
+            r->ptr[j] = r->ptr[j + 1];
+            r->liberer[j] = r->liberer[j + 1];
+        }
+        r->nb--;
+        return;
+    }
+}
+
+/* fonctions de libération pour suivreRessource */
+void ressourceFichier(void *f) {
+    fclose((FILE*)f);
+}
+
+void ressourceListe(void *la) {
+    free_liste_adjacence((liste_adjacence*)la);
+}
+
+void ressourcePartition(void *p) {
+    free_partition((t_partition*)p);
+}
+
+void ressourceLiens(void *liens) {
+    free_link_array((t_link_array*)liens);
+}
+
+void ressourcePile(void *s) {
+    free_stack((int_stack*)s);
+}
+
+/*écrit dans buf un identifiant lisible pour le sommet (A, ..., Z, AA, ..., ZZ, AAA...).
+ Numérotation bijective en base 26 : aucun plafond sur le nombre de sommets. */
+char* getIdR(int num, char *buf, size_t len) {
+    char tmp[16];
+    int k = 0;
     if (num <= 0) {
-        strcpy(id, "?");
-        return id;
+        snprintf(buf, len, "?");
+        return buf;
     }
-    num--; // 0-based
-    if (num < 26) {
-        id[0] = 'A' + num;
-        id[1] = '\0';
-    } else {
-        int first = (num / 26) - 1;
-        int second = num % 26;
-        id[0] = 'A' + first;
-        id[1] = 'A' + second;
-        id[2] = '\0';
+    while (num > 0 && k < (int)sizeof(tmp)) {
+        num--;
+        tmp[k++] = (char)('A' + num % 26);
+        num /= 26;
+    }
+    size_t i = 0;
+    for (; i < (size_t)k && i + 1 < len; i++) {
+        buf[i] = tmp[k - 1 - (int)i];
     }
-    return id;
+    if (len > 0) buf[i] = '\0';
+    return buf;
+}
+
+/*retourne un identifiant lisible pour le sommet (tampon propre à chaque thread). */
+char* getId(int num) {
+    static _Thread_local char id[16];
+    return getIdR(num, id, sizeof(id));
 }
 
-/* vérifie la somme des probabilités sortantes par sommet. */
-void verifierMarkov(liste_adjacence la) {
+/* vérifie la somme des probabilités sortantes par sommet ; renvoie 1 si le graphe est valide. */
+int verifierMarkov(liste_adjacence la) {
     int valide = 1;
     for (int i = 0; i < la.taille; i++) {
         float somme = 0.0f;
@@ -45,31 +136,69 @@ void verifierMarkov(liste_adjacence la) {
         printf("Le graphe est un graphe de Markov valide.\n");
     else
         printf("Le graphe n'est pas un graphe de Markov.\n");
+    return valide;
 }
 
-/* exporte la liste d'adjacence au format Mermaid. */
-void exporterMermaid(liste_adjacence la, const char* filename) {
+/* écrit la liste d'adjacence au format Mermaid, renvoie 0 ou -1 si le fichier ne peut être écrit. */
+int ecrireMermaid(liste_adjacence la, const char* filename) {
     FILE* file = fopen(filename, "wt");
     if (!file) {
-        perror("Erreur à l'ouverture du fichier de sortie Mermaid");
-        exit(EXIT_FAILURE);
+        return -1;
     }
-    fprintf(file, "---\n");
-    fprintf(file, "config:\n layout: elk\n theme: neo\n look: neo\n---\n");
-    fprintf(file, "flowchart LR\n");
+    t_ecrivain e;
+    initEcrivain(&e, file);
+    ecrireTexte(&e, "---\nconfig:\n layout: elk\n theme: neo\n look: neo\n---\nflowchart LR\n");
     for (int i = 0; i < la.taille; i++) {
-        fprintf(file, "%s((%d))\n", getId(i + 1), i + 1);
+        ecrireIdSommet(&e, i + 1);
+        ecrireTexte(&e, "((");
+        ecrireEntier(&e, i + 1);
+        ecrireTexte(&e, "))\n");
     }
     for (int i = 0; i < la.taille; i++) {
-        cellule* tmp = la.tab[i].head;
-        while (tmp) {
-            char idto[8];
-            strcpy(idto, getId(tmp->arrivee));
-            fprintf(file, "%s -->|%.2f|%s\n", getId(i + 1), tmp->proba, idto);
-            tmp = tmp->suivant;
+        for (cellule* tmp = la.tab[i].head; tmp; tmp = tmp->suivant) {
+            ecrireIdSommet(&e, i + 1);
+            ecrireTexte(&e, " -->|");
+            ecrireFlottant(&e, tmp->proba, 2);
+            ecrireCaractere(&e, '|');
+            ecrireIdSommet(&e, tmp->arrivee);
+            ecrireCaractere(&e, '\n');
+        }
+    }
+    int res = fermerEcrivain(&e);
+    return fclose(file) == 0 ? res : -1;
+}
+
+/* écrit la liste d'adjacence au format Graphviz DOT, renvoie 0 ou -1 si le fichier ne peut être écrit. */
+int ecrireDot(liste_adjacence la, const char* filename) {
+    FILE* file = fopen(filename, "wt");
+    if (!file) {
+        return -1;
+    }
+    t_ecrivain e;
+    initEcrivain(&e, file);
+    ecrireTexte(&e, "digraph markov {\n  rankdir=LR;\n");
+    for (int i = 0; i < la.taille; i++) {
+        for (cellule* tmp = la.tab[i].head; tmp; tmp = tmp->suivant) {
+            ecrireTexte(&e, "  ");
+            ecrireEntier(&e, i + 1);
+            ecrireTexte(&e, " -> ");
+            ecrireEntier(&e, tmp->arrivee);
+            ecrireTexte(&e, " [label=\"");
+            ecrireFlottant(&e, tmp->proba, 2);
+            ecrireTexte(&e, "\"];\n");
         }
     }
-    fclose(file);
+    ecrireTexte(&e, "}\n");
+    int res = fermerEcrivain(&e);
+    return fclose(file) == 0 ? res : -1;
+}
+
+/* exporte la liste d'adjacence au format Mermaid. */
+void exporterMermaid(liste_adjacence la, const char* filename) {
+    if (ecrireMermaid(la, filename) != 0) {
+        perror("Erreur à l'ouverture du fichier de sortie Mermaid");
+        exit(EXIT_FAILURE);
+    }
     printf("Fichier Mermaid généré : %s\n", filename);
 }
 
@@ -81,8 +210,7 @@ void exporterMermaid(liste_adjacence la, const char* filename) {
 t_tarjan_vertex* init_tarjan_vertices(int n) {
     t_tarjan_vertex *arr = (t_tarjan_vertex*)malloc(n * sizeof(t_tarjan_vertex));
     if (!arr) {
-        perror("Allocation tarjan vertices");
-        exit(EXIT_FAILURE);
+        erreurFatale("Allocation tarjan vertices");
     }
     for (int i = 0; i < n; i++) {
         arr[i].id = i + 1;   // sommet 1..n
@@ -97,6 +225,7 @@ t_tarjan_vertex* init_tarjan_vertices(int n) {
 void init_stack(int_stack *s) {
     s->cap = 16;
     s->data = (int*)malloc(s->cap * sizeof(int));
+    if (!s->data) { erreurFatale("alloc stack"); }
     s->top = 0;
 }
 
@@ -105,6 +234,7 @@ void push_stack(int_stack *s, int v) {
     if (s->top >= s->cap) {
         s->cap *= 2;
         s->data = (int*)realloc(s->data, s->cap * sizeof(int));
+        if (!s->data) { erreurFatale("alloc stack"); }
     }
     s->data[s->top++] = v;
 }
@@ -136,7 +266,7 @@ void init_partition(t_partition *p) {
     p->cap = 8;
     p->nb = 0;
     p->classes = (t_classe*)malloc(p->cap * sizeof(t_classe));
-    if (!p->classes) { perror("alloc partition"); exit(EXIT_FAILURE); }
+    if (!p->classes) { erreurFatale("alloc partition"); }
 }
 
 /* initialise une classe et son tableau de membres. */
@@ -146,7 +276,7 @@ void init_classe(t_classe *c, const char *name) {
     c->capacity = 8;
     c->size = 0;
     c->members = (int*)malloc(c->capacity * sizeof(int));
-    if (!c->members) { perror("alloc class members"); exit(EXIT_FAILURE); }
+    if (!c->members) { erreurFatale("alloc class members"); }
 }
 
 /*ajoute un sommet à la classe (réalloue si besoin). */
@@ -154,6 +284,7 @@ void add_member_to_classe(t_classe *c, int vertex) {
     if (c->size >= c->capacity) {
         c->capacity *= 2;
         c->members = (int*)realloc(c->members, c->capacity * sizeof(int));
+        if (!c->members) { erreurFatale("alloc class members"); }
     }
     c->members[c->size++] = vertex;
 }
@@ -163,6 +294,7 @@ void add_class(t_partition *p, t_classe c) {
     if (p->nb >= p->cap) {
         p->cap *= 2;
         p->classes = (t_classe*)realloc(p->classes, p->cap * sizeof(t_classe));
+        if (!p->classes) { erreurFatale("alloc partition"); }
     }
     p->classes[p->nb++] = c;
 }
@@ -233,15 +365,21 @@ t_partition tarjan(liste_adjacence la) {
     int n = la.taille;
     t_partition partition;
     init_partition(&partition);
+    suivreRessource(&partition, ressourcePartition);
     t_tarjan_vertex *V = init_tarjan_vertices(n);
+    suivreRessource(V, free);
     int index = 0;
     int_stack S;
     init_stack(&S);
+    suivreRessource(&S, ressourcePile);
     for (int v = 0; v < n; v++) {
         if (V[v].index == -1) {
             strongconnect(v, V, &index, &S, &partition, &la);
         }
     }
+    oublierRessource(&S);
+    oublierRessource(V);
+    oublierRessource(&partition);
     free_stack(&S);
     free(V);
     return partition;
@@ -255,7 +393,7 @@ void init_link_array(t_link_array *la) {
     la->cap = 8;
     la->size = 0;
     la->links = (t_link*)malloc(la->cap * sizeof(t_link));
-    if (!la->links) { perror("alloc links"); exit(EXIT_FAILURE); }
+    if (!la->links) { erreurFatale("alloc links"); }
 }
 
 /*retourne 1 si le lien from->to existe déjà, sinon 0. */
@@ -275,16 +413,29 @@ void add_link_if_not_exists(t_link_array *la, int from, int to) {
     if (la->size >= la->cap) {
         la->cap *= 2;
         la->links = (t_link*)realloc(la->links, la->cap * sizeof(t_link));
+        if (!la->links) { erreurFatale("alloc links"); }
     }
     la->links[la->size].from = from;
     la->links[la->size].to = to;
     la->size++;
 }
 
+/*retire le lien from->to s'il existe (renvoie 1 si supprimé, 0 sinon). */
+int remove_link(t_link_array *la, int from, int to) {
+    for (int i = 0; i < la->size; i++) {
+        if (la->links[i].from == from && la->links[i].to == to) {
+            la->links[i] = la->links[la->size - 1];
+            la->size--;
+            return 1;
+        }
+    }
+    return 0;
+}
+
 /* renvoie une table map[v] -> permet de savoir a quel classe appartient un sommet. */
 int* build_vertex_to_class_map(t_partition *p, int n) {
     int *map = (int*)malloc((n+1) * sizeof(int));
-    if (!map) { perror("alloc map"); exit(EXIT_FAILURE); }
+    if (!map) { erreurFatale("alloc map"); }
     for (int i = 1; i <= n; i++){
         map[i] = -1;
     } 
@@ -301,6 +452,7 @@ int* build_vertex_to_class_map(t_partition *p, int n) {
 t_link_array create_links_from_partition(liste_adjacence la, t_partition *p, int *vertex_to_class) {
     t_link_array arr;
     init_link_array(&arr);
+    suivreRessource(&arr, ressourceLiens);
     int n = la.taille;
     for (int i = 0; i < n; i++) {
         int Ci = vertex_to_class[i+1];
@@ -314,6 +466,7 @@ t_link_array create_links_from_partition(liste_adjacence la, t_partition *p, int
             cur = cur->suivant;
         }
     }
+    oublierRessource(&arr);
     return arr;
 }
 
@@ -325,33 +478,76 @@ void free_link_array(t_link_array *la) {
     la->size = la->cap = 0;
 }
 
-/*exporte le diagramme de Hasse au format Mermaid. */
-void exporterMermaidHasse(t_partition *p, t_link_array *links, const char *filename) {
+/* membres d'une classe séparés par des virgules (aucune troncature) */
+static void ecrireMembres(t_ecrivain *e, t_classe *c) {
+    for (int j = 0; j < c->size; j++) {
+        if (j > 0) ecrireCaractere(e, ',');
+        ecrireEntier(e, c->members[j]);
+    }
+}
+
+/*écrit le diagramme de Hasse au format Mermaid, renvoie 0 ou -1 si le fichier ne peut être écrit. */
+int ecrireMermaidHasse(t_partition *p, t_link_array *links, const char *filename) {
     FILE *f = fopen(filename, "wt");
-    if (!f) { perror("open hasse file"); exit(EXIT_FAILURE); }
-    fprintf(f, "---\n");
-    fprintf(f, "config:\n layout: elk\n theme: neo\n look: neo\n---\n");
-    fprintf(f, "flowchart LR\n");
+    if (!f) return -1;
+    t_ecrivain e;
+    initEcrivain(&e, f);
+    ecrireTexte(&e, "---\nconfig:\n layout: elk\n theme: neo\n look: neo\n---\nflowchart LR\n");
     for (int i = 0; i < p->nb; i++) {
-        char members[200];
-        members[0] = '\0';
-        for (int j = 0; j < p->classes[i].size; j++) {
-            char buf[16];
-            if (j == 0) snprintf(buf, sizeof(buf), "%d", p->classes[i].members[j]);
-            else snprintf(buf, sizeof(buf), ",%d", p->classes[i].members[j]);
-            strncat(members, buf, sizeof(members) - strlen(members) - 1);
-        }
-        /* Utiliser un saut de ligne HTML pour les labels Mermaid et citer l'étiquette */
-        char label[256];
-        snprintf(label, sizeof(label), "%s<br>{%s}", p->classes[i].name, members);
-        fprintf(f, "C%d[\"%s\"]\n", i+1, label);
+        /* saut de ligne HTML dans l'étiquette Mermaid, étiquette citée */
+        ecrireCaractere(&e, 'C');
+        ecrireEntier(&e, i + 1);
+        ecrireTexte(&e, "[\"");
+        ecrireTexte(&e, p->classes[i].name);
+        ecrireTexte(&e, "<br>{");
+        ecrireMembres(&e, &p->classes[i]);
+        ecrireTexte(&e, "}\"]\n");
     }
     for (int k = 0; k < links->size; k++) {
-        int from = links->links[k].from;
-        int to = links->links[k].to;
-        fprintf(f, "C%d --> C%d\n", from, to);
+        ecrireCaractere(&e, 'C');
+        ecrireEntier(&e, links->links[k].from);
+        ecrireTexte(&e, " --> C");
+        ecrireEntier(&e, links->links[k].to);
+        ecrireCaractere(&e, '\n');
+    }
+    int res = fermerEcrivain(&e);
+    return fclose(f) == 0 ? res : -1;
+}
+
+/*écrit le diagramme de Hasse au format Graphviz DOT, renvoie 0 ou -1 si le fichier ne peut être écrit. */
+int ecrireDotHasse(t_partition *p, t_link_array *links, const char *filename) {
+    FILE *f = fopen(filename, "wt");
+    if (!f) return -1;
+    t_ecrivain e;
+    initEcrivain(&e, f);
+    ecrireTexte(&e, "digraph hasse {\n  rankdir=LR;\n  node [shape=box];\n");
+    for (int i = 0; i < p->nb; i++) {
+        ecrireTexte(&e, "  C");
+        ecrireEntier(&e, i + 1);
+        ecrireTexte(&e, " [label=\"");
+        ecrireTexte(&e, p->classes[i].name);
+        ecrireTexte(&e, "\\n{");
+        ecrireMembres(&e, &p->classes[i]);
+        ecrireTexte(&e, "}\"];\n");
+    }
+    for (int k = 0; k < links->size; k++) {
+        ecrireTexte(&e, "  C");
+        ecrireEntier(&e, links->links[k].from);
+        ecrireTexte(&e, " -> C");
+        ecrireEntier(&e, links->links[k].to);
+        ecrireTexte(&e, ";\n");
+    }
+    ecrireTexte(&e, "}\n");
+    int res = fermerEcrivain(&e);
+    return fclose(f) == 0 ? res : -1;
+}
+
+/*exporte le diagramme de Hasse au format Mermaid. */
+void exporterMermaidHasse(t_partition *p, t_link_array *links, const char *filename) {
+    if (ecrireMermaidHasse(p, links, filename) != 0) {
+        perror("open hasse file");
+        exit(EXIT_FAILURE);
     }
-    fclose(f);
     printf("Fichier Mermaid Hasse généré : %s\n", filename);
 }
 